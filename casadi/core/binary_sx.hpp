@@ -39,6 +39,7 @@ namespace casadi {
 
     \identifier{115} */
 class BinarySX : public SXNode {
+    friend class SXNode;
   private:
 
     /** \brief  Constructor is private, use "create" below
@@ -62,7 +63,8 @@ class BinarySX : public SXNode {
         return ret_val;
       } else {
         // Expression containing free variables
-        return SXElem::create(new BinarySX(op, dep0, dep1));
+        if (GlobalOptions::sx_hash_consing) return hash_cons(op, dep0, &dep1);
+        return SXElem::create(SXNode::alloc<BinarySX>(op, dep0, dep1));
       }
     }
 
@@ -73,6 +75,7 @@ class BinarySX : public SXNode {
 
         \identifier{118} */
     ~BinarySX() override {
+      if (hash_consed_) hash_cons_release();
       safe_delete(dep0_.assignNoDelete(casadi_limits<SXElem>::nan));
       safe_delete(dep1_.assignNoDelete(casadi_limits<SXElem>::nan));
     }
@@ -144,7 +147,7 @@ class BinarySX : public SXNode {
       SXElem dep0, dep1;
       s.unpack("UnarySX::dep0", dep0);
       s.unpack("UnarySX::dep1", dep1);
-      return new BinarySX(op, dep0, dep1);
+      return SXNode::alloc<BinarySX>(op, dep0, dep1);
     }
 };
 
@@ -38,6 +38,7 @@
 #define CASADI_NEED_UNISTD
 #endif
 #include <random>
+#include <iomanip>
 #include <chrono>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -297,6 +298,25 @@ namespace casadi {
     return ret;
   }
 
+  std::string json_escape(const std::string& s) {
+    std::stringstream ss;
+    for (char c : s) {
+      switch (c) {
+        case '"': ss << "\\\""; break;
+        case '\\': ss << "\\\\"; break;
+        case '\n': ss << "\\n"; break;
+        case '\t': ss << "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+          } else {
+            ss << c;
+          }
+      }
+    }
+    return ss.str();
+  }
+
 #ifdef HAVE_SIMPLE_MKSTEMPS
 int simple_mkstemps_fd(const std::string& prefix, const std::string& suffix, std::string &result) {
     // Characters available for inventing filenames
@@ -95,6 +95,9 @@ private:
   CASADI_EXPORT std::string replace(const std::string& s,
     const std::string& p, const std::string& r);
 
+  /// Escape s for use in a JSON string literal
+  CASADI_EXPORT std::string json_escape(const std::string& s);
+
   /**  \brief Range function
 
   * \param stop
@@ -61,6 +61,9 @@ namespace casadi {
     this->force_canonical = false;
 
     avoid_stack_ = false;
+    chunk_size_ = 0;
+    n_units_ = 1;
+    loop_rolling_ = false;
     indent_ = 2;
     sz_zeros_ = 0;
     sz_ones_ = 0;
@@ -108,6 +111,14 @@ namespace casadi {
         casadi_assert_dev(indent_>=0);
       } else if (e.first=="avoid_stack") {
         avoid_stack_ = e.second;
+      } else if (e.first=="chunk_size") {
+        chunk_size_ = e.second;
+        casadi_assert(chunk_size_>=0, "Option chunk_size must be >=0");
+      } else if (e.first=="n_units") {
+        n_units_ = e.second;
+        casadi_assert(n_units_>=1, "Option n_units must be >=1");
+      } else if (e.first=="loop_rolling") {
+        loop_rolling_ = e.second;
       } else if (e.first=="prefix") {
         this->prefix = e.second.to_string();
         prefix_set = true;
@@ -198,6 +209,7 @@ namespace casadi {
       this->prefix = this->name;
     }
 
+    unit_body_.resize(n_units_);
   }
 
   void CodeGenerator::scope_enter() {
@@ -500,6 +512,16 @@ namespace casadi {
     // Finalize file
     file_close(s, this->cpp);
 
+    // Secondary compilation units
+    unit_files_.clear();
+    for (casadi_int k=1; k<n_units_; ++k) {
+      unit_files_.push_back(prefix + this->name + "_u" + str(k) + this->suffix);
+      file_open(s, unit_files_.back(), this->cpp);
+      dump_preamble(s, k);
+      s << unit_body_[k] << std::endl;
+      file_close(s, this->cpp);
+    }
+
     // Generate s-function
     if (this->with_sfunction) {
       for (unsigned ii=0; ii<this->added_sfunctions.size(); ii++) {
@@ -843,49 +865,6 @@ namespace casadi {
     // Consistency check
     casadi_assert_dev(current_indent_ == 0);
 
-    // Prefix internal symbols to avoid symbol collisions
-    s << "/* How to prefix internal symbols */\n"
-      << "#ifdef CASADI_CODEGEN_PREFIX\n"
-      << "  #define CASADI_NAMESPACE_CONCAT(NS, ID) _CASADI_NAMESPACE_CONCAT(NS, ID)\n"
-      << "  #define _CASADI_NAMESPACE_CONCAT(NS, ID) NS ## ID\n"
-      << "  #define CASADI_PREFIX(ID) CASADI_NAMESPACE_CONCAT(CODEGEN_PREFIX, ID)\n"
-      << "#else\n"
-      << "  #define CASADI_PREFIX(ID) " << this->prefix << "_ ## ID\n"
-      << "#endif\n\n";
-
-    s << this->includes.str();
-    s << std::endl;
-
-    // Numeric types after includes: may depend on them. e.g. mex type
-    // Real type (usually double)
-    generate_casadi_real(s);
-
-    // Integer type (usually long long)
-    generate_casadi_int(s);
-
-    if (needs_mem_) {
-      s << "#ifndef CASADI_MAX_NUM_THREADS\n";
-      s << "#define CASADI_MAX_NUM_THREADS 1\n";
-      s << "#endif\n\n";
-    }
-
-    // casadi/mem after numeric types to define derived types
-    // Memory struct entry point
-    if (this->with_mem) {
-      s << "#include <casadi/mem.h>\n" << std::endl;
-    }
-
-    // Macros
-    if (!added_shorthands_.empty()) {
-      s << "/* Add prefix to internal symbols */\n";
-      for (auto&& i : added_shorthands_) {
-        s << "#define " << "casadi_" << i <<  " CASADI_PREFIX(" << i <<  ")\n";
-      }
-      s << std::endl;
-    }
-
-    if (this->with_export) generate_export_symbol(s);
-
     // Check if inf/nan is needed
     for (const auto& d : double_constants_) {
       for (double e : d) {
@@ -894,8 +873,8 @@ namespace casadi {
       }
     }
 
-    // Codegen auxiliary functions
-    s << this->auxiliaries.str();
+    // Declarations shared with the secondary compilation units
+    dump_preamble(s, 0);
 
     // Print integer constants
     if (!integer_constants_.empty()) {
@@ -986,6 +965,68 @@ namespace casadi {
     s << std::endl;
   }
 
+  void CodeGenerator::dump_preamble(std::ostream& s, casadi_int unit) {
+    // Prefix internal symbols to avoid symbol collisions
+    s << "/* How to prefix internal symbols */\n"
+      << "#ifdef CASADI_CODEGEN_PREFIX\n"
+      << "  #define CASADI_NAMESPACE_CONCAT(NS, ID) _CASADI_NAMESPACE_CONCAT(NS, ID)\n"
+      << "  #define _CASADI_NAMESPACE_CONCAT(NS, ID) NS ## ID\n"
+      << "  #define CASADI_PREFIX(ID) CASADI_NAMESPACE_CONCAT(CODEGEN_PREFIX, ID)\n"
+      << "#else\n"
+      << "  #define CASADI_PREFIX(ID) " << this->prefix << "_ ## ID\n"
+      << "#endif\n\n";
+
+    s << this->includes.str();
+    s << std::endl;
+
+    // Numeric types after includes: may depend on them. e.g. mex type
+    // Real type (usually double)
+    generate_casadi_real(s);
+
+    // Integer type (usually long long)
+    generate_casadi_int(s);
+
+    if (needs_mem_) {
+      s << "#ifndef CASADI_MAX_NUM_THREADS\n";
+      s << "#define CASADI_MAX_NUM_THREADS 1\n";
+      s << "#endif\n\n";
+    }
+
+    // casadi/mem after numeric types to define derived types
+    // Memory struct entry point
+    if (this->with_mem) {
+      s << "#include <casadi/mem.h>\n" << std::endl;
+    }
+
+    // Macros
+    if (!added_shorthands_.empty()) {
+      s << "/* Add prefix to internal symbols */\n";
+      for (auto&& i : added_shorthands_) {
+        // Symbols private to a secondary compilation unit get a unit-specific name
+        std::string id = unit==0 || unit_shorthands_.count(i) ? i : "u" + str(unit) + "_" + i;
+        s << "#define " << "casadi_" << i <<  " CASADI_PREFIX(" << id <<  ")\n";
+      }
+      s << std::endl;
+    }
+
+    if (this->with_export) generate_export_symbol(s);
+
+    // Codegen auxiliary functions
+    s << this->auxiliaries.str();
+  }
+
+  void CodeGenerator::add_unit_function(const std::string& name,
+      const std::string& definition) {
+    casadi_assert(n_units_>1, "No secondary compilation units");
+    unit_shorthands_.insert(name);
+    // Least loaded unit
+    casadi_int k = 1;
+    for (casadi_int i=2; i<n_units_; ++i) {
+      if (unit_body_[i].size() < unit_body_[k].size()) k = i;
+    }
+    unit_body_[k] += definition;
+  }
+
   std::string CodeGenerator::work(casadi_int n, casadi_int sz, bool is_ref) const {
     if (is_ref) {
       return "wr" + format_padded(n);
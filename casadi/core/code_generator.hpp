@@ -65,6 +65,14 @@ namespace casadi {
         \identifier{rv} */
     std::string generate(const std::string& prefix="");
 
+    /** \brief Secondary compilation units written by the last call to generate
+
+      With the "n_units" option, functions that can be compiled separately are
+      distributed over additional files, to be compiled in parallel and linked
+      together with the main file.
+    */
+    std::vector<std::string> units() const { return unit_files_;}
+
     /// Add an include file optionally using a relative path "..." instead of an absolute path <...>
     void add_include(const std::string& new_include, bool relative_path=false,
                     const std::string& use_ifdef=std::string());
@@ -263,6 +271,27 @@ namespace casadi {
         \identifier{si} */
     bool avoid_stack() const { return avoid_stack_;}
 
+    /** \brief Maximum number of instructions per generated function, 0 for no limit
+
+        Larger SXFunction bodies are split into chunks sharing the work vector */
+    casadi_int chunk_size() const { return chunk_size_;}
+
+    /** \brief Number of compilation units */
+    casadi_int n_units() const { return n_units_;}
+
+    /** \brief Roll repeated instruction blocks into loops?
+
+        Repeated isomorphic blocks of SXFunction instructions are generated as
+        loops over index tables, with the work vector stored in w */
+    bool loop_rolling() const { return loop_rolling_;}
+
+    /** \brief Add a function definition to the least loaded secondary compilation unit
+
+        The function must be self-contained: it may only refer to its arguments,
+        auxiliaries and other functions added this way.
+        Name is the shorthand id of the function. */
+    void add_unit_function(const std::string& name, const std::string& definition);
+
     /** \brief Print a constant in a lossless but compact manner
 
         \identifier{sj} */
@@ -935,6 +964,27 @@ namespace casadi {
     // Do we want to be lean on stack usage?
     bool avoid_stack_;
 
+    // Maximum number of instructions per generated function
+    casadi_int chunk_size_;
+
+    // Number of compilation units
+    casadi_int n_units_;
+
+    // Roll repeated instruction blocks into loops
+    bool loop_rolling_;
+
+    // Function definitions of the secondary compilation units
+    std::vector<std::string> unit_body_;
+
+    // Shorthands with the same meaning in all compilation units
+    std::set<std::string> unit_shorthands_;
+
+    // Files of the secondary compilation units
+    std::vector<std::string> unit_files_;
+
+    // Print the declarations shared by all compilation units
+    void dump_preamble(std::ostream& s, casadi_int unit);
+
     std::string infinity, nan, real_min;
 
     /** \brief Codegen scalar
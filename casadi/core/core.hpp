@@ -33,6 +33,7 @@
 #include "polynomial.hpp"
 #include "casadi_misc.hpp"
 #include "global_options.hpp"
+#include "trace_recorder.hpp"
 #include "casadi_meta.hpp"
 
 // Matrices
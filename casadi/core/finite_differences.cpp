@@ -24,9 +24,25 @@
 
 
 #include "finite_differences.hpp"
+#include "casadi_enum.hpp"
+#include "thread_pool.hpp"
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif // WITH_OPENMP
 
 namespace casadi {
 
+std::string to_string(Parallelization v) {
+  switch (v) {
+  case Parallelization::SERIAL: return "serial";
+  case Parallelization::OPENMP: return "openmp";
+  case Parallelization::THREAD: return "thread";
+  default: break;
+  }
+  return "";
+}
+
 std::string to_string(FdMode v) {
   switch (v) {
   case FdMode::FORWARD: return "forward";
@@ -98,6 +114,13 @@ const Options FiniteDiff::options_
       {OT_INT,
       "Number of iterations to improve on the step-size "
       "[default: 1 if error estimate available, otherwise 0]"}},
+    {"parallelization",
+      {OT_STRING,
+      "Evaluation of the directional derivatives [SERIAL|openmp|thread]"}},
+    {"num_threads",
+      {OT_INT,
+      "Maximum number of directions evaluated concurrently "
+      "[default: size of the global thread pool]"}},
     }
 };
 
@@ -114,6 +137,8 @@ void FiniteDiff::init(const Dict& opts) {
   h_ = calc_stepsize(m_.abstol);
   u_aim_ = 100;
   h_iter_ = has_err() ? 1 : 0;
+  parallelization_ = Parallelization::SERIAL;
+  casadi_int num_threads = 0;
 
   // Read options
   for (auto&& op : opts) {
@@ -133,6 +158,10 @@ void FiniteDiff::init(const Dict& opts) {
       u_aim_ = op.second;
     } else if (op.first=="h_iter") {
       h_iter_ = op.second;
+    } else if (op.first=="parallelization") {
+      parallelization_ = to_enum<Parallelization>(op.second, "serial");
+    } else if (op.first=="num_threads") {
+      num_threads = op.second;
     }
   }
 
@@ -143,22 +172,53 @@ void FiniteDiff::init(const Dict& opts) {
     "Choose a different differencing scheme.");
   }
 
-  // Allocate work vector for (perturbed) inputs and outputs
+  // Maximum number of concurrent tasks
+  switch (parallelization_) {
+    case Parallelization::SERIAL:
+      break;
+#ifdef WITH_OPENMP
+    case Parallelization::OPENMP:
+      if (num_threads<=0) num_threads = omp_get_max_threads();
+      break;
+#endif // WITH_OPENMP
+#ifdef CASADI_WITH_THREAD
+    case Parallelization::THREAD:
+      if (num_threads<=0) num_threads = ThreadPool::global().size();
+      break;
+#endif // CASADI_WITH_THREAD
+    default:
+      casadi_warning("Parallelization " + to_string(parallelization_)
+        + " not enabled during compilation. Falling back to serial evaluation");
+      parallelization_ = Parallelization::SERIAL;
+      break;
+  }
+  n_task_ = parallelization_ == Parallelization::SERIAL ? 1 :
+    std::max(std::min(num_threads, n_), casadi_int(1));
+
+  // Work vectors for a single task
   n_z_ = derivative_of_.nnz_in();
   n_y_ = derivative_of_.nnz_out();
-  alloc_res(n_pert(), true); // yk
-  alloc_w((n_pert() + 3) * n_y_, true); // yk[:], y0, y, J
-  alloc_w(n_z_, true); // z
+  derivative_of_.sz_work(sz_arg_task_, sz_res_task_, sz_iw_task_, sz_w_task_);
+  sz_res_task_ += n_pert(); // yk
+  sz_w_task_ += (n_pert() + 2) * n_y_ + n_z_; // yk[:], y, J, z
+
+  // Allocate work vector for (perturbed) inputs and outputs of each task
+  alloc_w(n_y_, true); // y0
+  alloc_arg(sz_arg_task_ * n_task_);
+  alloc_res(sz_res_task_ * n_task_);
+  alloc_iw(sz_iw_task_ * n_task_);
+  alloc_w(sz_w_task_ * n_task_);
 
   // Dimensions
   if (verbose_) {
     casadi_message("Finite differences (" + class_name() + ") with "
                     + str(n_z_) + " inputs, " + str(n_y_)
                     + " outputs and " + str(n_) + " directional derivatives.");
+    if (n_task_>1) {
+      casadi_message("Evaluating up to " + str(n_task_) + " directions concurrently ("
+                     + to_string(parallelization_) + ")");
+    }
   }
-
-  // Allocate sufficient temporary memory for function evaluation
-  alloc(derivative_of_);
 }
 
 Sparsity FiniteDiff::get_sparsity_in(casadi_int i) {
@@ -234,7 +294,6 @@ int FiniteDiff::eval(const double** arg, double** res,
   setup(mem, arg, res, iw, w);
   // Shorthands
   casadi_int n_in = derivative_of_.n_in(), n_out = derivative_of_.n_out();
-  casadi_int n_pert = this->n_pert();
 
   // Non-differentiated input
   const double** x0 = arg;
@@ -256,6 +315,43 @@ int FiniteDiff::eval(const double** arg, double** res,
   double** sens = res;
   res += n_out;
 
+  // Serial evaluation
+  if (n_task_==1) return eval_task(0, 1, x0, y0, seed, sens, arg, res, iw, w);
+
+  // Each task evaluates every n_task_-th direction with its own work vectors
+  auto task = [&](casadi_int t) {
+    try {
+      return eval_task(t, n_task_, x0, y0, seed, sens,
+        arg + t*sz_arg_task_, res + t*sz_res_task_, iw + t*sz_iw_task_, w + t*sz_w_task_);
+    } catch (std::exception& e) {
+      casadi_warning("Exception raised: " + std::string(e.what()));
+      return 1;
+    }
+  };
+  int flag = 0;
+  if (parallelization_ == Parallelization::OPENMP) {
+#ifdef WITH_OPENMP
+    #pragma omp parallel for reduction(||:flag) num_threads(n_task_)
+    for (casadi_int t=0; t<n_task_; ++t) {
+      flag = task(t) || flag;
+    }
+#endif // WITH_OPENMP
+  } else if (parallelization_ == Parallelization::THREAD) {
+    // Tasks are dispatched to the persistent pool, the calling thread takes part
+    flag = ThreadPool::global().run(n_task_, task);
+  } else {
+    casadi_error("Unknown parallelization: " + to_string(parallelization_));
+  }
+  return flag;
+}
+
+int FiniteDiff::eval_task(casadi_int offset, casadi_int stride,
+    const double** x0, double* y0, const double** seed, double** sens,
+    const double** arg, double** res, casadi_int* iw, double* w) const {
+  // Shorthands
+  casadi_int n_in = derivative_of_.n_in(), n_out = derivative_of_.n_out();
+  casadi_int n_pert = this->n_pert();
+
   // Finite difference approximation
   double* J = w;
   w += n_y_;
@@ -281,8 +377,11 @@ int FiniteDiff::eval(const double** arg, double** res,
     w += derivative_of_.nnz_out(j);
   }
 
-  // For all sensitivity directions
-  for (casadi_int i=0; i<n_; ++i) {
+  // Memory object used for all evaluations of the task
+  scoped_checkout<Function> mem(derivative_of_);
+
+  // For all sensitivity directions of the task
+  for (casadi_int i=offset; i<n_; i+=stride) {
     // Initial stepsize
     double h = h_;
     // Perform finite difference algorithm with different step sizes
@@ -298,7 +397,7 @@ int FiniteDiff::eval(const double** arg, double** res,
           off += nnz;
         }
         // Evaluate
-        if (derivative_of_(arg, res, iw, w)) return 1;
+        if (derivative_of_(arg, res, iw, w, mem)) return 1;
         // Save outputs
         casadi_copy(y, n_y_, yk[k]);
       }
@@ -38,6 +38,12 @@ enum class FdMode {FORWARD, BACKWARD, CENTRAL, SMOOTHING, NUMEL};
 /// Convert to string
 CASADI_EXPORT std::string to_string(FdMode v);
 
+/// Type of parallelization
+enum class Parallelization {SERIAL, OPENMP, THREAD, NUMEL};
+
+/// Convert to string
+CASADI_EXPORT std::string to_string(Parallelization v);
+
 /// Length of FD stencil, including unperturbed input
 CASADI_EXPORT casadi_int n_fd_points(FdMode v);
 
@@ -120,6 +126,11 @@ public:
   // Evaluate numerically
   int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
 
+  // Evaluate directions offset, offset+stride, ... using a separate work vector
+  int eval_task(casadi_int offset, casadi_int stride, const double** x0, double* y0,
+    const double** seed, double** sens, const double** arg, double** res,
+    casadi_int* iw, double* w) const;
+
   /** \brief Is the scheme using the (nondifferentiated) output?
 
       \identifier{1ue} */
@@ -182,6 +193,15 @@ protected:
 
   // Memory object
   casadi_finite_diff_mem<double> m_;
+
+  // Parallel evaluation of the directions
+  Parallelization parallelization_;
+
+  // Number of directions evaluated concurrently
+  casadi_int n_task_;
+
+  // Work vector size per task
+  size_t sz_arg_task_, sz_res_task_, sz_iw_task_, sz_w_task_;
 };
 
 /** Calculate derivative using forward differences
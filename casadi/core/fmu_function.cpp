@@ -1352,16 +1352,6 @@ void FmuFunction::make_symmetric(double *hess_nz, casadi_int* iw) const {
   }
 }
 
-std::string to_string(Parallelization v) {
-  switch (v) {
-  case Parallelization::SERIAL: return "serial";
-  case Parallelization::OPENMP: return "openmp";
-  case Parallelization::THREAD: return "thread";
-  default: break;
-  }
-  return "";
-}
-
 bool has_prefix(const std::string& s) {
   return s.find('_') < s.size();
 }
@@ -83,12 +83,6 @@ struct CASADI_EXPORT FmuMemory : public FunctionMemory {
   explicit FmuMemory(const FmuFunction& self) : self(self), instance(nullptr) {}
 };
 
-/// Type of parallelization
-enum class Parallelization {SERIAL, OPENMP, THREAD, NUMEL};
-
-/// Convert to string
-CASADI_EXPORT std::string to_string(Parallelization v);
-
 // Types of inputs
 enum class InputType {REG, FWD, ADJ, OUT, ADJ_OUT};
 
@@ -743,6 +743,17 @@ namespace casadi {
     }
   }
 
+  Function
+  Function::map(casadi_int n, const std::string& parallelization, const Dict& opts) const {
+    // No options: default map
+    if (opts.empty()) return map(n, parallelization);
+    // Make sure not degenerate
+    casadi_assert(n>0, "Degenerate map operation");
+    casadi_assert(parallelization!="unroll" && parallelization!="inline",
+      "Options not supported for parallelization '" + parallelization + "'");
+    return (*this)->map(n, parallelization, opts);
+  }
+
   Function Function::
   slice(const std::string& name, const std::vector<casadi_int>& order_in,
         const std::vector<casadi_int>& order_out, const Dict& opts) const {
@@ -1152,6 +1163,14 @@ namespace casadi {
     (*this)->print_dimensions(stream);
   }
 
+  void Function::print_profile(std::ostream &stream) const {
+    (*this)->print_profile(stream);
+  }
+
+  void Function::save_profile(const std::string &fname) const {
+    (*this)->save_profile(fname);
+  }
+
   void Function::print_options(std::ostream &stream) const {
     (*this)->print_options(stream);
   }
@@ -1268,7 +1287,14 @@ namespace casadi {
 
   void Function::save(const std::string &fname, const Dict& opts) const {
     FileSerializer fs(fname, opts);
-    fs.pack(*this);
+    try {
+      fs.pack(*this);
+    } catch (...) {
+      // Leave the existing file untouched
+      fs.discard();
+      throw;
+    }
+    fs.finalize();
   }
 
   std::string Function::serialize(const Dict& opts) const {
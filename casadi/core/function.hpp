@@ -440,6 +440,21 @@ namespace casadi {
         \identifier{1vy} */
     void print_dimensions(std::ostream &stream=casadi::uout()) const;
 
+    /** \brief Print a report of the time spent per instruction
+
+        Accumulated over all evaluations, sorted by time, both per instruction type
+        and per instruction. Requires the option "profile_instructions"
+        (MXFunction and SXFunction).
+    */
+    void print_profile(std::ostream &stream=casadi::uout()) const;
+
+    /** \brief Save the time spent per instruction to a JSON file
+
+        Chrome trace event format, viewable with chrome://tracing, Perfetto or speedscope.
+        Requires the option "profile_instructions" (MXFunction and SXFunction).
+    */
+    void save_profile(const std::string &fname) const;
+
     /** \brief Print options to a stream
 
         \identifier{1vz} */
@@ -729,12 +744,15 @@ namespace casadi {
                 s_(N-1) <- f(a_(N-1), p_(N-1))
         \endverbatim
 
-        \param parallelization Type of parallelization used: unroll|serial|openmp
+        \param parallelization Type of parallelization used:
+                               unroll|serial|openmp|thread|thread_pool|simd
 
         \identifier{1wj} */
     Function map(casadi_int n, const std::string& parallelization="serial") const;
     Function map(casadi_int n, const std::string& parallelization,
       casadi_int max_num_threads) const;
+    Function map(casadi_int n, const std::string& parallelization,
+      const Dict& opts) const;
 
     ///@{
     /** \brief Map with reduction
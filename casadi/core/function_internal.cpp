@@ -45,6 +45,7 @@
 #include "fmu_function.hpp"
 #include "blazing_spline_impl.hpp"
 #include "filesystem_impl.hpp"
+#include "thread_pool.hpp"
 
 #include <cctype>
 #include <typeinfo>
@@ -120,8 +121,8 @@ namespace casadi {
   }
 
   ProtoFunction::~ProtoFunction() {
-    for (void* m : mem_) {
-      if (m!=nullptr) casadi_warning("Memory object has not been properly freed");
+    for (int i=0; i<mem_.size(); ++i) {
+      if (mem_.at(i)!=nullptr) casadi_warning("Memory object has not been properly freed");
     }
     mem_.clear();
   }
@@ -131,6 +132,12 @@ namespace casadi {
       std::string jit_directory = get_from_dict(jit_options_, "directory", std::string(""));
       std::string jit_name = jit_directory + jit_name_ + ".c";
       if (remove(jit_name.c_str())) casadi_warning("Failed to remove " + jit_name);
+      // Secondary compilation units
+      casadi_int n_units = get_from_dict(jit_codegen_options_, "n_units", casadi_int(1));
+      for (casadi_int k=1; k<n_units; ++k) {
+        jit_name = jit_directory + jit_name_ + "_u" + str(k) + ".c";
+        if (remove(jit_name.c_str())) casadi_warning("Failed to remove " + jit_name);
+      }
     }
   }
 
@@ -257,6 +264,11 @@ namespace casadi {
       {"jit_options",
        {OT_DICT,
         "Options to be passed to the jit compiler."}},
+      {"jit_codegen_options",
+       {OT_DICT,
+        "Options to be passed to the code generator when just-in-time compiling, "
+        "e.g. chunk_size and n_units to split large functions over compilation units "
+        "that the shell compiler builds in parallel."}},
       {"derivative_of",
        {OT_FUNCTION,
         "The function is a derivative of another function. "
@@ -389,6 +401,7 @@ namespace casadi {
     opts["jit_serialize"] = jit_serialize_;
     opts["compiler"] = compiler_plugin_;
     opts["jit_options"] = jit_options_;
+    opts["jit_codegen_options"] = jit_codegen_options_;
     opts["jit_name"] = jit_base_name_;
     opts["jit_temp_suffix"] = jit_temp_suffix_;
     opts["ad_weight"] = ad_weight_;
@@ -479,6 +492,8 @@ namespace casadi {
         compiler_plugin_ = op.second.to_string();
       } else if (op.first=="jit_options") {
         jit_options_ = op.second;
+      } else if (op.first=="jit_codegen_options") {
+        jit_codegen_options_ = op.second;
       } else if (op.first=="jit_name") {
         jit_base_name_ = op.second.to_string();
       } else if (op.first=="jit_temp_suffix") {
@@ -694,14 +709,17 @@ namespace casadi {
         if (compiler_.is_null()) {
           if (verbose_) casadi_message("Codegenerating function '" + name_ + "'.");
           // JIT everything
-          Dict opts;
+          Dict opts = jit_codegen_options_;
           // Override the default to avoid random strings in the generated code
           opts["prefix"] = "jit";
           CodeGenerator gen(jit_name_, opts);
           gen.add(self());
           if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
           std::string jit_directory = get_from_dict(jit_options_, "directory", std::string(""));
-          compiler_ = Importer(gen.generate(jit_directory), compiler_plugin_, jit_options_);
+          std::string source = gen.generate(jit_directory);
+          Dict jit_options = jit_options_;
+          if (!gen.units().empty()) jit_options["units"] = gen.units();
+          compiler_ = Importer(source, compiler_plugin_, jit_options);
           if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
         }
         // Try to load
@@ -835,6 +853,7 @@ namespace casadi {
     if (dump_ && dump_id==0) dump();
     if (print_in_) print_in(uout(), arg, false);
     auto m = static_cast<ProtoFunctionMemory*>(mem);
+    TraceScope trace(trace_name_, name_, m->mem_id);
 
     // Avoid memory corruption
     for (casadi_int i=0;i<n_in_;++i) {
@@ -909,6 +928,27 @@ namespace casadi {
     }
   }
 
+  void FunctionInternal::get_profile(InstructionStats& stats, std::vector<std::string>& type,
+      std::vector<std::string>& descr) const {
+    casadi_error("'get_profile' not defined for " + class_name());
+  }
+
+  void FunctionInternal::print_profile(std::ostream &stream) const {
+    InstructionStats stats;
+    std::vector<std::string> type, descr;
+    get_profile(stats, type, descr);
+    stats.disp(stream, name_, type, descr);
+  }
+
+  void FunctionInternal::save_profile(const std::string& fname) const {
+    InstructionStats stats;
+    std::vector<std::string> type, descr;
+    get_profile(stats, type, descr);
+    std::ofstream of;
+    Filesystem::open(of, fname);
+    stats.to_trace(of, name_, type, descr);
+  }
+
   void ProtoFunction::print_options(std::ostream &stream) const {
     get_options().print_all(stream);
   }
@@ -1004,9 +1044,10 @@ namespace casadi {
     cache_.tocache_if_missing(f.name() + ":" + suffix, f);
   }
 
-  Function FunctionInternal::map(casadi_int n, const std::string& parallelization) const {
+  Function FunctionInternal::map(casadi_int n, const std::string& parallelization,
+      const Dict& opts) const {
     Function f;
-    if (parallelization=="serial") {
+    if (parallelization=="serial" && opts.empty()) {
       // Serial maps are cached
       std::string fname = "map" + str(n) + "_" + name_;
       if (!incache(fname, f)) {
@@ -1018,7 +1059,7 @@ namespace casadi {
       }
     } else {
       // Non-serial maps are not cached
-      f = Map::create(parallelization, self(), n);
+      f = Map::create(parallelization, self(), n, opts);
     }
     return f;
   }
@@ -1112,6 +1153,10 @@ namespace casadi {
         if (!f->is_diff_out_[i] && res[i]) casadi_clear(res[i], f->nnz_out(i));
       }
     }
+    static inline int sp_wide(const FunctionInternal *f, const bvec_t** arg, bvec_t** res,
+                              bvec_t* w, casadi_int n_word) {
+      return f->sp_forward_wide(arg, res, w, n_word);
+    }
   };
   template<> struct JacSparsityTraits<false> {
     typedef bvec_t* arg_t;
@@ -1126,6 +1171,10 @@ namespace casadi {
         if (!f->is_diff_in_[i] && arg[i]) casadi_clear(arg[i], f->nnz_in(i));
       }
     }
+    static inline int sp_wide(const FunctionInternal *f, bvec_t** arg, bvec_t** res,
+                              bvec_t* w, casadi_int n_word) {
+      return f->sp_reverse_wide(arg, res, w, n_word);
+    }
   };
 
   template<bool fwd>
@@ -1234,6 +1283,110 @@ namespace casadi {
     return ret;
   }
 
+  template<bool fwd>
+  Sparsity FunctionInternal::get_jac_sparsity_wide(casadi_int oind, casadi_int iind) const {
+    // Number of nonzero inputs and outputs
+    casadi_int nz_in = nnz_in(iind);
+    casadi_int nz_out = nnz_out(oind);
+
+    // No dependencies through non-differentiable inputs or outputs
+    if (!is_diff_in_[iind] || !is_diff_out_[oind]) return Sparsity(nz_out, nz_in);
+
+    // Directions per sweep
+    casadi_int n_word = sp_wide_words();
+    casadi_int n_dir = n_word * bvec_size;
+
+    // Number of seeds and sensitivities
+    casadi_int n_seed = fwd ? nz_in : nz_out;
+    casadi_int n_sens = fwd ? nz_out : nz_in;
+
+    // Number of sweeps we must make
+    casadi_int nsweep = n_seed / n_dir;
+    if (n_seed % n_dir) nsweep++;
+
+    // Sweeps are distributed over threads
+    casadi_int n_thread = std::max(casadi_int(1), std::min(sp_wide_threads(), nsweep));
+
+    // Print
+    if (verbose_) {
+      casadi_message(str(nsweep) + std::string(fwd ? " forward" : " reverse") + " sweeps "
+                     "of " + str(n_dir) + " directions needed for " + str(n_seed) + " directions, "
+                     "using " + str(n_thread) + " thread(s)");
+    }
+
+    // Triplets, per thread
+    std::vector< std::vector<casadi_int> > jcol(n_thread), jrow(n_thread);
+
+    // Sweeps s, s+n_thread, s+2*n_thread, ...
+    auto sweeps = [&](casadi_int t) -> int {
+      // Evaluation buffers
+      std::vector<typename JacSparsityTraits<fwd>::arg_t> arg(n_in_, nullptr);
+      std::vector<bvec_t*> res(n_out_, nullptr);
+      std::vector<bvec_t> w(sz_w_sp_wide(n_word), 0);
+      std::vector<bvec_t> seed(n_seed * n_word, 0), sens(n_sens * n_word, 0);
+      if (fwd) {
+        arg[iind] = get_ptr(seed);
+        res[oind] = get_ptr(sens);
+      } else {
+        arg[iind] = get_ptr(sens);
+        res[oind] = get_ptr(seed);
+      }
+      for (casadi_int s=t; s<nsweep; s+=n_thread) {
+        // Seed directions offset, ..., offset+ndir_local-1
+        casadi_int offset = s*n_dir;
+        casadi_int ndir_local = std::min(n_dir, n_seed-offset);
+        for (casadi_int i=0; i<ndir_local; ++i) {
+          seed[(offset+i)*n_word + i/bvec_size] = bvec_t(1) << (i%bvec_size);
+        }
+
+        // Propagate the dependencies
+        if (!fwd) std::fill(sens.begin(), sens.end(), bvec_t(0));
+        if (JacSparsityTraits<fwd>::sp_wide(this, get_ptr(arg), get_ptr(res), get_ptr(w),
+                                            n_word)) return 1;
+
+        // Collect dependencies
+        for (casadi_int el=0; el<n_sens; ++el) {
+          for (casadi_int k=0; k<n_word; ++k) {
+            bvec_t spsens = sens[el*n_word + k];
+            if (spsens==0) continue;
+            for (casadi_int i=0; i<bvec_size; ++i) {
+              if ((bvec_t(1) << i) & spsens) {
+                jcol[t].push_back(el);
+                jrow[t].push_back(offset + k*bvec_size + i);
+              }
+            }
+          }
+        }
+
+        // Remove the seeds
+        for (casadi_int i=0; i<ndir_local; ++i) {
+          seed[(offset+i)*n_word + i/bvec_size] = 0;
+        }
+      }
+      return 0;
+    };
+    if (n_thread==1) {
+      casadi_assert(!sweeps(0), "Sparsity propagation failed");
+    } else {
+      casadi_assert(!ThreadPool::global().run(n_thread, sweeps), "Sparsity propagation failed");
+    }
+
+    // Merge triplets
+    for (casadi_int t=1; t<n_thread; ++t) {
+      jcol[0].insert(jcol[0].end(), jcol[t].begin(), jcol[t].end());
+      jrow[0].insert(jrow[0].end(), jrow[t].begin(), jrow[t].end());
+    }
+
+    // Construct sparsity pattern and return
+    if (!fwd) swap(jrow[0], jcol[0]);
+    Sparsity ret = Sparsity::triplet(nz_out, nz_in, jcol[0], jrow[0]);
+    if (verbose_) {
+      casadi_message("Formed Jacobian sparsity pattern (dimension " + str(ret.size()) + ", "
+          + str(ret.nnz()) + " (" + str(ret.density()) + " %) nonzeros.");
+    }
+    return ret;
+  }
+
   Sparsity FunctionInternal::get_jac_sparsity_hierarchical_symm(casadi_int oind,
       casadi_int iind) const {
     casadi_assert_dev(has_spfwd());
@@ -1800,7 +1953,18 @@ namespace casadi {
       if (w == -1) return Sparsity();
 
       Sparsity sp;
-      if (nnz_in(iind) > 3*bvec_size && nnz_out(oind) > 3*bvec_size &&
+      casadi_int n_word = sp_wide_words();
+      if (n_word>0) {
+        // Wide sparsity propagation: number of forward and adjoint sweeps
+        casadi_int n_dir = n_word * bvec_size;
+        casadi_int nsweep_fwd = (nnz_in(iind) + n_dir - 1) / n_dir;
+        casadi_int nsweep_adj = (nnz_out(oind) + n_dir - 1) / n_dir;
+        if (w*static_cast<double>(nsweep_fwd) <= (1-w)*static_cast<double>(nsweep_adj)) {
+          sp = get_jac_sparsity_wide<true>(oind, iind);
+        } else {
+          sp = get_jac_sparsity_wide<false>(oind, iind);
+        }
+      } else if (nnz_in(iind) > 3*bvec_size && nnz_out(oind) > 3*bvec_size &&
             GlobalOptions::hierarchical_sparsity) {
         if (symmetric) {
           sp = get_jac_sparsity_hierarchical_symm(oind, iind);
@@ -2818,6 +2982,16 @@ namespace casadi {
     return 0;
   }
 
+  int FunctionInternal::sp_forward_wide(const bvec_t** arg, bvec_t** res, bvec_t* w,
+      casadi_int n_word) const {
+    casadi_error("'sp_forward_wide' not defined for " + class_name());
+  }
+
+  int FunctionInternal::sp_reverse_wide(bvec_t** arg, bvec_t** res, bvec_t* w,
+      casadi_int n_word) const {
+    casadi_error("'sp_reverse_wide' not defined for " + class_name());
+  }
+
   void FunctionInternal::sz_work(size_t& sz_arg, size_t& sz_res,
                                  size_t& sz_iw, size_t& sz_w) const {
     sz_arg = this->sz_arg();
@@ -3471,8 +3645,9 @@ namespace casadi {
   }
 
   void ProtoFunction::clear_mem() {
-    for (auto&& i : mem_) {
-      if (i!=nullptr) free_mem(i);
+    for (int i=0; i<mem_.size(); ++i) {
+      void* m = mem_.at(i);
+      if (m!=nullptr) free_mem(m);
     }
     mem_.clear();
   }
@@ -3572,9 +3747,6 @@ namespace casadi {
   }
 
   void* ProtoFunction::memory(int ind) const {
-#ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
     return mem_.at(ind);
   }
 
@@ -3583,31 +3755,28 @@ namespace casadi {
   }
 
   int ProtoFunction::checkout() const {
+    // Fast path: reuse an unused memory object, lock-free
+    int ind = mem_.pop();
+    if (ind>=0) return ind;
 #ifdef CASADI_WITH_THREAD
     std::lock_guard<std::mutex> lock(mtx_);
 #endif //CASADI_WITH_THREAD
-    if (unused_.empty()) {
-      check_mem_count(mem_.size()+1);
-      // Allocate a new memory object
-      void* m = alloc_mem();
-      mem_.push_back(m);
-      if (init_mem(m)) {
-        casadi_error("Failed to create or initialize memory object");
-      }
-      return static_cast<int>(mem_.size()) - 1;
-    } else {
-      // Use an unused memory object
-      int m = unused_.top();
-      unused_.pop();
-      return m;
+    // An object may have been released while waiting for the lock
+    ind = mem_.pop();
+    if (ind>=0) return ind;
+    check_mem_count(mem_.size()+1);
+    // Allocate a new memory object
+    void* m = alloc_mem();
+    ind = mem_.add(m);
+    static_cast<ProtoFunctionMemory*>(m)->mem_id = ind;
+    if (init_mem(m)) {
+      casadi_error("Failed to create or initialize memory object");
     }
+    return ind;
   }
 
   void ProtoFunction::release(int mem) const {
-#ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
-    unused_.push(mem);
+    mem_.push(mem);
   }
 
   Function FunctionInternal::
@@ -3901,7 +4070,7 @@ namespace casadi {
 
   void FunctionInternal::serialize_body(SerializingStream& s) const {
     ProtoFunction::serialize_body(s);
-    s.version("FunctionInternal", 6);
+    s.version("FunctionInternal", 7);
     s.pack("FunctionInternal::is_diff_in", is_diff_in_);
     s.pack("FunctionInternal::is_diff_out", is_diff_out_);
     s.pack("FunctionInternal::sp_in", sparsity_in_);
@@ -3923,6 +4092,7 @@ namespace casadi {
     s.pack("FunctionInternal::jit_temp_suffix", jit_temp_suffix_);
     s.pack("FunctionInternal::jit_base_name", jit_base_name_);
     s.pack("FunctionInternal::jit_options", jit_options_);
+    s.pack("FunctionInternal::jit_codegen_options", jit_codegen_options_);
     s.pack("FunctionInternal::compiler_plugin", compiler_plugin_);
     s.pack("FunctionInternal::has_refcount", has_refcount_);
 
@@ -3977,7 +4147,7 @@ namespace casadi {
   }
 
   FunctionInternal::FunctionInternal(DeserializingStream& s) : ProtoFunction(s) {
-    int version = s.version("FunctionInternal", 1, 6);
+    int version = s.version("FunctionInternal", 1, 7);
     s.unpack("FunctionInternal::is_diff_in", is_diff_in_);
     s.unpack("FunctionInternal::is_diff_out", is_diff_out_);
     s.unpack("FunctionInternal::sp_in", sparsity_in_);
@@ -4000,8 +4170,7 @@ namespace casadi {
         std::ifstream binary(library, std::ios_base::binary);
         if (binary.good()) { // library exists
           // Ignore packed contents
-          std::stringstream ss;
-          s.unpack("FunctionInternal::jit_binary", ss);
+          s.skip_blob("FunctionInternal::jit_binary");
         } else { // library does not exist
           std::ofstream binary(library, std::ios_base::binary | std::ios_base::out);
           s.unpack("FunctionInternal::jit_binary", binary);
@@ -4012,6 +4181,9 @@ namespace casadi {
     s.unpack("FunctionInternal::jit_temp_suffix", jit_temp_suffix_);
     s.unpack("FunctionInternal::jit_base_name", jit_base_name_);
     s.unpack("FunctionInternal::jit_options", jit_options_);
+    if (version >= 7) {
+      s.unpack("FunctionInternal::jit_codegen_options", jit_codegen_options_);
+    }
     s.unpack("FunctionInternal::compiler_plugin", compiler_plugin_);
     s.unpack("FunctionInternal::has_refcount", has_refcount_);
 
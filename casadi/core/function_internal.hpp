@@ -34,6 +34,8 @@
 #include "options.hpp"
 #include "shared_object.hpp"
 #include "timing.hpp"
+#include "memory_pool.hpp"
+#include "trace_recorder.hpp"
 #ifdef CASADI_WITH_THREAD
 #ifdef CASADI_WITH_THREAD_MINGW
 #include <mingw.mutex.h>
@@ -70,6 +72,9 @@ namespace casadi {
     // Short-hand for "total" fstats
     FStats* t_total;
 
+    // Index in the memory pool of the owning function, see checkout
+    int mem_id = -1;
+
     // Add a statistic
     void add_stat(const std::string& s) {
       bool added = fstats.insert(std::make_pair(s, FStats())).second;
@@ -260,6 +265,9 @@ namespace casadi {
     /// Throw an exception on failure?
     bool error_on_fail_;
 
+    /// Name of evaluation events, see TraceRecorder
+    TraceName trace_name_;
+
   protected:
     /** \brief Deserializing constructor
 
@@ -272,11 +280,8 @@ namespace casadi {
 #endif // CASADI_WITH_THREAD
 
   private:
-    /// Memory objects
-    mutable std::vector<void*> mem_;
-
-    /// Unused memory objects
-    mutable std::stack<int> unused_;
+    /// Memory objects, with lock-free checkout of unused objects
+    mutable MemoryPool mem_;
   };
 
   /** \brief Internal class for Function
@@ -949,6 +954,19 @@ namespace casadi {
         \identifier{mb} */
     void print_dimensions(std::ostream &stream) const;
 
+    /** \brief Get accumulated per-instruction statistics
+
+        Summed over all memory objects. type and descr classify and describe each instruction.
+    */
+    virtual void get_profile(InstructionStats& stats, std::vector<std::string>& type,
+                             std::vector<std::string>& descr) const;
+
+    /** \brief Print a report of the per-instruction statistics */
+    void print_profile(std::ostream &stream) const;
+
+    /** \brief Save the per-instruction statistics in the Chrome trace event format */
+    void save_profile(const std::string& fname) const;
+
     /** \brief Print free variables
 
         \identifier{mc} */
@@ -1024,6 +1042,10 @@ namespace casadi {
     template<bool fwd>
     Sparsity get_jac_sparsity_gen(casadi_int oind, casadi_int iind) const;
 
+    /// A flavor of get_jac_sparsity_gen using wide sparsity propagation
+    template<bool fwd>
+    Sparsity get_jac_sparsity_wide(casadi_int oind, casadi_int iind) const;
+
     /// A flavor of get_jac_sparsity_gen that does hierarchical block structure recognition
     Sparsity get_jac_sparsity_hierarchical(casadi_int oind, casadi_int iind) const;
 
@@ -1156,6 +1178,31 @@ namespace casadi {
         \identifier{my} */
     virtual int sp_reverse(bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w, void* mem) const;
 
+    /** \brief Number of bvec_t words per nonzero for wide sparsity propagation
+
+        If nonzero, sp_forward_wide and sp_reverse_wide propagate n_word*bvec_size
+        directions at once. Zero (the default) if not available.
+    */
+    virtual casadi_int sp_wide_words() const { return 0;}
+
+    /** \brief Maximum number of threads for wide sparsity propagation */
+    virtual casadi_int sp_wide_threads() const { return 1;}
+
+    /** \brief Work vector size (in bvec_t) for wide sparsity propagation */
+    virtual size_t sz_w_sp_wide(casadi_int n_word) const { return 0;}
+
+    /** \brief Propagate sparsity forward, n_word words per nonzero
+
+        Nonzero k of input/output i occupies arg[i][k*n_word], ..., arg[i][k*n_word+n_word-1].
+        Must be thread-safe: no memory object is used.
+    */
+    virtual int sp_forward_wide(const bvec_t** arg, bvec_t** res, bvec_t* w,
+                                casadi_int n_word) const;
+
+    /** \brief Propagate sparsity backwards, n_word words per nonzero */
+    virtual int sp_reverse_wide(bvec_t** arg, bvec_t** res, bvec_t* w,
+                                casadi_int n_word) const;
+
     /** \brief Get number of temporary variables needed
 
         \identifier{mz} */
@@ -1247,7 +1294,8 @@ namespace casadi {
     /** \brief Generate/retrieve cached serial map
 
         \identifier{nd} */
-    Function map(casadi_int n, const std::string& parallelization) const;
+    Function map(casadi_int n, const std::string& parallelization,
+      const Dict& opts=Dict()) const;
 
     /** \brief Export an input file that can be passed to generate C code with a main
 
@@ -1348,6 +1396,9 @@ namespace casadi {
     Importer compiler_;
     Dict jit_options_;
 
+    /// Options passed to CodeGenerator when just-in-time compiling
+    Dict jit_codegen_options_;
+
     /// Penalty factor for using a complete Jacobian to calculate directional derivatives
     double jac_penalty_;
 
@@ -44,4 +44,14 @@ namespace casadi {
 
   casadi_int GlobalOptions::copy_elision_min_size = 8;
 
+  casadi_int GlobalOptions::thread_pool_size = 0;
+
+  bool GlobalOptions::thread_pool_pinning = false;
+
+  bool GlobalOptions::sx_node_pool = false;
+
+  bool GlobalOptions::sx_hash_consing = false;
+
+  casadi_int GlobalOptions::coloring_threads = 1;
+
 } // namespace casadi
@@ -74,6 +74,16 @@ namespace casadi {
 
       static casadi_int copy_elision_min_size;
 
+      static casadi_int thread_pool_size;
+
+      static bool thread_pool_pinning;
+
+      static bool sx_node_pool;
+
+      static bool sx_hash_consing;
+
+      static casadi_int coloring_threads;
+
 #endif //SWIG
       // Setter and getter for simplification_on_the_fly
       static void setSimplificationOnTheFly(bool flag) { simplification_on_the_fly = flag; }
@@ -100,6 +110,48 @@ namespace casadi {
       }
       static casadi_int getCopyElisionMinSize() { return copy_elision_min_size; }
 
+      /** \brief Number of threads in the process-wide thread pool
+
+      * Used by map with "thread_pool" parallelization. 0 means hardware concurrency.
+      * Must be set before the pool is used for the first time.
+      */
+      static void setThreadPoolSize(casadi_int n) { thread_pool_size = n; }
+      static casadi_int getThreadPoolSize() { return thread_pool_size; }
+
+      /** \brief Pin the worker threads of the thread pool to dedicated cores
+
+      * Must be set before the pool is used for the first time.
+      */
+      static void setThreadPoolPinning(bool flag) { thread_pool_pinning = flag; }
+      static bool getThreadPoolPinning() { return thread_pool_pinning; }
+
+      /** \brief Allocate new SX nodes from a slab allocator with per-thread free lists
+
+      * Reduces allocator contention when building, expanding and destroying large
+      * expression graphs. Existing nodes are unaffected by a change.
+      */
+      static void setSXNodePool(bool flag) { sx_node_pool = flag; }
+      static bool getSXNodePool() { return sx_node_pool; }
+
+      /** \brief Share structurally identical SX operation nodes as they are created
+
+      * A unary or binary operation on the same dependency nodes returns the node
+      * created earlier, if it is still alive, instead of a new one. This removes
+      * redundancy as the graph is built rather than in a later cse pass.
+      * Only nodes created while enabled are shared.
+      */
+      static void setSXHashConsing(bool flag) { sx_hash_consing = flag; }
+      static bool getSXHashConsing() { return sx_hash_consing; }
+
+      /** \brief Number of threads for coloring Jacobian and Hessian sparsity patterns
+
+      * 1 (default) colors sequentially, 0 uses all threads of the thread pool.
+      * Otherwise, patterns with many columns are colored speculatively in parallel,
+      * which may result in a different coloring than the sequential algorithm.
+      */
+      static void setColoringThreads(casadi_int n) { coloring_threads = n; }
+      static casadi_int getColoringThreads() { return coloring_threads; }
+
   };
 
 } // namespace casadi
@@ -1867,6 +1867,8 @@ FixedStepIntegrator::FixedStepIntegrator(const std::string& name, const Function
 
   // Default options
   nk_target_ = 20;
+  checkpoints_ = -1;
+  dense_output_ = false;
 }
 
 FixedStepIntegrator::~FixedStepIntegrator() {
@@ -1879,16 +1881,59 @@ const Options FixedStepIntegrator::options_
       {OT_INT,
       "Target number of finite elements. "
       "The actual number may be higher to accommodate all output times"}},
+    {"checkpoints",
+      {OT_INT,
+      "Number of states kept in memory for the backward integration. "
+      "The forward trajectory is recomputed from these, placed according to the binomial "
+      "(revolve) schedule. Default -1: store the state at every finite element"}},
+    {"dense_output",
+      {OT_BOOL,
+      "Place the finite elements independently of the output times, only respecting "
+      "step changes in the controls, and evaluate the outputs by cubic Hermite "
+      "interpolation. Requires an ODE without events or adjoint sensitivities. "
+      "Default: false"}},
     {"simplify",
       {OT_BOOL,
       "Implement as MX Function (codegeneratable/serializable) default: false"}},
     {"simplify_options",
       {OT_DICT,
-      "Any options to pass to simplified form Function constructor"}}
+      "Any options to pass to simplified form Function constructor"}},
+    {"batch",
+      {OT_INT,
+      "Integrate this many trajectories in lockstep, returning an MX Function with the "
+      "inputs and outputs of map(batch) on the integrator. Each step is a single call for "
+      "all trajectories: vectorized for SX dynamics and, for implicit schemes, "
+      "with one Newton iteration for all trajectories. Options are passed as for 'simplify'"}}
     }
 };
 
 
+/* Position of the next checkpoint when advancing from a checkpoint at capo towards fine,
+ * with snaps checkpoints including the one at capo. From the revolve algorithm,
+ * A. Griewank and A. Walther, ACM TOMS 26(1), 2000.
+ */
+static casadi_int revolve_advance(casadi_int capo, casadi_int fine, casadi_int snaps) {
+  casadi_int reps = 0, range = 1;
+  while (range < fine - capo) {
+    reps++;
+    range = range * (reps + snaps) / reps;
+  }
+  casadi_int bino1 = range * reps / (snaps + reps);
+  casadi_int bino2 = snaps > 1 ? bino1 * snaps / (snaps + reps - 1) : 1;
+  casadi_int bino3 = snaps == 1 ? 0 : snaps > 2 ? bino2 * (snaps - 1) / (snaps + reps - 2) : 1;
+  casadi_int bino4 = bino2 * (reps - 1) / snaps;
+  casadi_int bino5 = snaps < 3 ? 0 : snaps > 3 ? bino3 * (snaps - 2) / reps : 1;
+  casadi_int next;
+  if (fine - capo <= bino1 + bino3) {
+    next = capo + bino4;
+  } else if (fine - capo >= range - bino5) {
+    next = capo + bino1;
+  } else {
+    next = fine - bino2 - bino3;
+  }
+  return std::max(capo + 1, next);
+}
+
 Function FixedStepIntegrator::create_advanced(const Dict& opts) {
   Function temp = Function::create(this, opts);
 
@@ -1897,6 +1942,15 @@ Function FixedStepIntegrator::create_advanced(const Dict& opts) {
   auto it = opts.find("simplify");
   if (it != opts.end()) simplify = it->second;
 
+  // Batched integration of multiple trajectories
+  it = opts.find("batch");
+  if (it != opts.end()) {
+    casadi_int n = it->second;
+    casadi_assert(n > 0, "Batch size must be strictly positive");
+    casadi_assert(!dense_output_, "Option 'batch' cannot be combined with 'dense_output'");
+    return create_batch(temp.name(), n, opts);
+  }
+
   if (simplify && nrx_==0 && nt()==1) {
     // Retrieve explicit simulation step (one finite element)
     Function F = get_function("step");
@@ -1952,6 +2006,84 @@ Function FixedStepIntegrator::create_advanced(const Dict& opts) {
   }
 }
 
+Function FixedStepIntegrator::create_batch(const std::string& name, casadi_int n,
+    const Dict& opts) const {
+  casadi_assert(nrx_ == 0 && ne_ == 0,
+    "Batched integration is not supported with backward states or events");
+
+  // Discrete time dynamics for all trajectories
+  Function F = batch_step(n);
+
+  // Inputs, one column (block of columns for the controls) per trajectory
+  std::vector<MX> intg_in(INTEGRATOR_NUM_IN);
+  for (casadi_int i = 0; i < INTEGRATOR_NUM_IN; ++i) {
+    intg_in[i] = MX::sym(name_in_.at(i), repmat(sparsity_in(i), 1, n));
+  }
+
+  // Columns ordered by trajectory, or by output time
+  std::vector<casadi_int> by_traj(nt() * n), by_time(nt() * n);
+  for (casadi_int s = 0; s < n; ++s) {
+    for (casadi_int k = 0; k < nt(); ++k) {
+      by_traj[s * nt() + k] = k * n + s;
+      by_time[k * n + s] = s * nt() + k;
+    }
+  }
+  MX u = intg_in[INTEGRATOR_U](Slice(), by_time);
+
+  // Initial conditions
+  std::vector<MX> F_in(STEP_NUM_IN);
+  F_in[STEP_X0] = intg_in[INTEGRATOR_X0];
+  F_in[STEP_V0] = algebraic_state_init(intg_in[INTEGRATOR_X0], intg_in[INTEGRATOR_Z0]);
+  F_in[STEP_P] = intg_in[INTEGRATOR_P];
+  MX q = MX::zeros(nq_, n);
+
+  // Loop over output times
+  std::vector<MX> xf, zf, qf;
+  double t = t0_;
+  for (casadi_int k = 0; k < nt(); ++k) {
+    F_in[STEP_U] = u(Slice(), Slice(k * n, (k + 1) * n));
+    // Loop over finite elements
+    casadi_int nj = disc_[k + 1] - disc_[k];
+    double h = (tout_[k] - t) / static_cast<double>(nj);
+    for (casadi_int j = 0; j < nj; ++j) {
+      F_in[STEP_T] = t + static_cast<double>(j) * h;
+      F_in[STEP_H] = h;
+      std::vector<MX> F_out = F(F_in);
+      F_in[STEP_X0] = F_out[STEP_XF];
+      F_in[STEP_V0] = F_out[STEP_VF];
+      q += F_out[STEP_QF];
+    }
+    xf.push_back(F_in[STEP_X0]);
+    if (nz_ > 0) zf.push_back(algebraic_state_output(F_in[STEP_V0]));
+    qf.push_back(q);
+    t = tout_[k];
+  }
+
+  // Outputs, one column (block of columns) per trajectory
+  std::vector<MX> intg_out(INTEGRATOR_NUM_OUT);
+  for (casadi_int i = 0; i < INTEGRATOR_NUM_OUT; ++i) {
+    intg_out[i] = MX(repmat(sparsity_out(i), 1, n));
+  }
+  intg_out[INTEGRATOR_XF] = horzcat(xf)(Slice(), by_traj);
+  if (nz_ > 0) intg_out[INTEGRATOR_ZF] = horzcat(zf)(Slice(), by_traj);
+  intg_out[INTEGRATOR_QF] = horzcat(qf)(Slice(), by_traj);
+
+  // Extract options for Function constructor
+  Dict sopts;
+  sopts["print_time"] = print_time_;
+  auto it = opts.find("simplify_options");
+  if (it!=opts.end()) update_dict(sopts, it->second);
+
+  return Function(name, intg_in, intg_out, integrator_in(), integrator_out(), sopts);
+}
+
+Function FixedStepIntegrator::batch_step(casadi_int n) const {
+  Function F = get_function("step");
+  // Vectorized evaluation needs the dynamics in SX form
+  if (oracle_.is_a("SXFunction")) F = F.expand();
+  return F.map(n, F.is_a("SXFunction") ? "simd" : "serial");
+}
+
 void FixedStepIntegrator::init(const Dict& opts) {
   // Call the base class init
   Integrator::init(opts);
@@ -1960,11 +2092,22 @@ void FixedStepIntegrator::init(const Dict& opts) {
   for (auto&& op : opts) {
     if (op.first=="number_of_finite_elements") {
       nk_target_ = op.second;
+    } else if (op.first=="checkpoints") {
+      checkpoints_ = op.second;
+    } else if (op.first=="dense_output") {
+      dense_output_ = op.second;
     }
   }
 
   // Consistency check
   casadi_assert(nk_target_ > 0, "Number of finite elements must be strictly positive");
+  casadi_assert(checkpoints_ == -1 || checkpoints_ > 0,
+    "Number of checkpoints must be strictly positive, or -1 to store all states");
+  if (dense_output_) {
+    casadi_assert(nz1_ == 0, "Dense output is only supported for ODEs");
+    casadi_assert(ne_ == 0, "Dense output cannot be combined with events");
+    casadi_assert(nrx_ == 0, "Dense output does not support adjoint sensitivities");
+  }
 
   // Target interval length
   double h_target = (tout_.back() - t0_) / nk_target_;
@@ -1981,6 +2124,9 @@ void FixedStepIntegrator::init(const Dict& opts) {
   // Setup discrete time dynamics
   setup_step();
 
+  // Dense output interpolates using the time derivatives at the step boundaries
+  if (dense_output_ && nfwd_ > 0) create_forward("dae", nfwd_);
+
   // Get discrete time dimensions
   const Function& F = get_function(has_function("step") ? "step" : "implicit_step");
   nv1_ = F.nnz_out(STEP_VF);
@@ -1999,10 +2145,46 @@ void FixedStepIntegrator::init(const Dict& opts) {
   alloc_w(nrq_, true); // adj_p_prev
   alloc_w(nuq_, true); // adj_u_prev
 
+  // Work vectors, dense output
+  if (dense_output_) {
+    alloc_w(nx_, true); // x_step
+    alloc_w(nx_, true); // x_step_prev
+    alloc_w(nq_, true); // q_step
+    alloc_w(nq_, true); // q_step_prev
+    alloc_w(nx_, true); // xdot_step
+    alloc_w(nx_, true); // xdot_step_prev
+    alloc_w(nq_, true); // qdot_step
+    alloc_w(nq_, true); // qdot_step_prev
+  }
+
+  // Checkpoints stored during the forward sweep, unless all steps fit in the budget
+  ckp_fwd_.clear();
+  if (nrx_ > 0 && checkpoints_ > 0 && checkpoints_ < disc_.back()) {
+    ckp_fwd_.push_back(0);
+    while (static_cast<casadi_int>(ckp_fwd_.size()) < checkpoints_) {
+      casadi_int free = checkpoints_ - static_cast<casadi_int>(ckp_fwd_.size());
+      casadi_int c = revolve_advance(ckp_fwd_.back(), disc_.back(), free + 1);
+      if (c >= disc_.back() - 1) break;
+      ckp_fwd_.push_back(c);
+    }
+  }
+
   // Allocate tape if backward states are present
   if (nrx_ > 0) {
-    alloc_w((disc_.back() + 1) * nx_, true); // x_tape
-    alloc_w(disc_.back() * nv_, true); // v_tape
+    if (ckp_fwd_.empty()) {
+      alloc_w((disc_.back() + 1) * nx_, true); // x_tape
+      alloc_w(disc_.back() * nv_, true); // v_tape
+    } else {
+      alloc_w(checkpoints_ * nx_, true); // x_tape
+      alloc_w(checkpoints_ * nv_, true); // v_tape
+      alloc_iw(checkpoints_, true); // ckp_ind
+      alloc_w(nt() * nu_, true); // u_tape
+      alloc_w(nx_, true); // x_rec
+      alloc_w(nv_, true); // v_rec
+      alloc_w(nx_, true); // x_rec2
+      alloc_w(nv_, true); // v_rec2
+      alloc_w(nq_, true); // q_rec
+    }
   }
 }
 
@@ -2024,10 +2206,34 @@ void FixedStepIntegrator::set_work(void* mem, const double**& arg, double**& res
   m->adj_p_prev = w; w += nrq_;
   m->adj_u_prev = w; w += nuq_;
 
+  // Work vectors, dense output
+  if (dense_output_) {
+    m->x_step = w; w += nx_;
+    m->x_step_prev = w; w += nx_;
+    m->q_step = w; w += nq_;
+    m->q_step_prev = w; w += nq_;
+    m->xdot_step = w; w += nx_;
+    m->xdot_step_prev = w; w += nx_;
+    m->qdot_step = w; w += nq_;
+    m->qdot_step_prev = w; w += nq_;
+  }
+
   // Allocate tape if backward states are present
   if (nrx_ > 0) {
-    m->x_tape = w; w += (disc_.back() + 1) * nx_;
-    m->v_tape = w; w += disc_.back() * nv_;
+    if (ckp_fwd_.empty()) {
+      m->x_tape = w; w += (disc_.back() + 1) * nx_;
+      m->v_tape = w; w += disc_.back() * nv_;
+    } else {
+      m->x_tape = w; w += checkpoints_ * nx_;
+      m->v_tape = w; w += checkpoints_ * nv_;
+      m->ckp_ind = iw; iw += checkpoints_;
+      m->u_tape = w; w += nt() * nu_;
+      m->x_rec = w; w += nx_;
+      m->v_rec = w; w += nv_;
+      m->x_rec2 = w; w += nx_;
+      m->v_rec2 = w; w += nv_;
+      m->q_rec = w; w += nq_;
+    }
   }
 }
 
@@ -2038,9 +2244,107 @@ int FixedStepIntegrator::init_mem(void* mem) const {
   return 0;
 }
 
+Dict FixedStepIntegrator::get_stats(void* mem) const {
+  Dict stats = Integrator::get_stats(mem);
+  auto m = static_cast<FixedStepMemory*>(mem);
+  stats["nsteps"] = m->nsteps;
+  return stats;
+}
+
+void FixedStepIntegrator::calc_deriv(FixedStepMemory* m, double t, const double* x,
+    double* xdot, double* qdot) const {
+  // Evaluate nondifferentiated
+  m->arg[DYN_T] = &t;  // t
+  m->arg[DYN_X] = x;  // x
+  m->arg[DYN_Z] = nullptr;  // z
+  m->arg[DYN_P] = m->p;  // p
+  m->arg[DYN_U] = m->u;  // u
+  m->res[DYN_ODE] = xdot;  // ode
+  m->res[DYN_ALG] = nullptr;  // alg
+  m->res[DYN_QUAD] = qdot;  // quad
+  m->res[DYN_ZERO] = nullptr;  // zero
+  calc_function(m, "dae");
+  // Evaluate sensitivities
+  if (nfwd_ > 0) {
+    m->arg[DYN_NUM_IN + DYN_ODE] = xdot;  // out:ode
+    m->arg[DYN_NUM_IN + DYN_ALG] = nullptr;  // out:alg
+    m->arg[DYN_NUM_IN + DYN_QUAD] = qdot;  // out:quad
+    m->arg[DYN_NUM_IN + DYN_ZERO] = nullptr;  // out:zero
+    m->arg[DYN_NUM_IN + DYN_NUM_OUT + DYN_T] = nullptr;  // fwd:t
+    m->arg[DYN_NUM_IN + DYN_NUM_OUT + DYN_X] = x + nx1_;  // fwd:x
+    m->arg[DYN_NUM_IN + DYN_NUM_OUT + DYN_Z] = nullptr;  // fwd:z
+    m->arg[DYN_NUM_IN + DYN_NUM_OUT + DYN_P] = m->p + np1_;  // fwd:p
+    m->arg[DYN_NUM_IN + DYN_NUM_OUT + DYN_U] = m->u + nu1_;  // fwd:u
+    m->res[DYN_ODE] = xdot + nx1_;  // fwd:ode
+    m->res[DYN_ALG] = nullptr;  // fwd:alg
+    m->res[DYN_QUAD] = qdot + nq1_;  // fwd:quad
+    m->res[DYN_ZERO] = nullptr;  // fwd:zero
+    calc_function(m, forward_name("dae", nfwd_));
+  }
+}
+
+void FixedStepIntegrator::advance_dense(FixedStepMemory* m) const {
+  // Take steps until the output time is within the last step
+  while (m->k_step < m->n_step
+      && m->t_next - (m->t_seg + m->k_step * m->h_step) > 1e-9 * m->h_step) {
+    // Current time
+    double t = m->t_seg + m->k_step * m->h_step;
+
+    // Update the previous step
+    std::swap(m->x_step, m->x_step_prev);
+    std::swap(m->q_step, m->q_step_prev);
+    std::swap(m->xdot_step, m->xdot_step_prev);
+    std::swap(m->qdot_step, m->qdot_step_prev);
+    casadi_copy(m->v, nv_, m->v_prev);
+
+    // Take step
+    stepF(m, t, m->h_step, m->x_step_prev, m->v_prev, m->x_step, m->v, m->q_step);
+    casadi_axpy(nq_, 1., m->q_step_prev, m->q_step);
+    calc_deriv(m, t + m->h_step, m->x_step, m->xdot_step, m->qdot_step);
+    m->k_step++;
+    m->nsteps++;
+  }
+
+  // Fraction of the last step at the output time
+  double tau = 1;
+  if (m->k_step > 0) {
+    tau = (m->t_next - (m->t_seg + (m->k_step - 1) * m->h_step)) / m->h_step;
+  }
+
+  // Output time at a step boundary
+  if (tau >= 1 - 1e-9) {
+    casadi_copy(m->x_step, nx_, m->x);
+    casadi_copy(m->q_step, nq_, m->q);
+    return;
+  }
+
+  // Cubic Hermite basis, derivative terms scaled by the step size
+  double tau2 = tau * tau, tau3 = tau2 * tau;
+  double h00 = 2 * tau3 - 3 * tau2 + 1;
+  double h01 = 3 * tau2 - 2 * tau3;
+  double h10 = m->h_step * (tau3 - 2 * tau2 + tau);
+  double h11 = m->h_step * (tau3 - tau2);
+
+  // Interpolate the last step
+  for (casadi_int i = 0; i < nx_; ++i) {
+    m->x[i] = h00 * m->x_step_prev[i] + h01 * m->x_step[i]
+      + h10 * m->xdot_step_prev[i] + h11 * m->xdot_step[i];
+  }
+  for (casadi_int i = 0; i < nq_; ++i) {
+    m->q[i] = h00 * m->q_step_prev[i] + h01 * m->q_step[i]
+      + h10 * m->qdot_step_prev[i] + h11 * m->qdot_step[i];
+  }
+}
+
 int FixedStepIntegrator::advance_noevent(IntegratorMemory* mem) const {
   auto m = static_cast<FixedStepMemory*>(mem);
 
+  // Steps are independent of the output times
+  if (dense_output_) {
+    advance_dense(m);
+    return 0;
+  }
+
   // State at previous step
   double* x_prev = m->tmp1;
 
@@ -2048,6 +2352,9 @@ int FixedStepIntegrator::advance_noevent(IntegratorMemory* mem) const {
   casadi_int nj = disc_[m->k + 1] - disc_[m->k];
   double h = (m->t_next - m->t) / nj;
 
+  // Controls are needed to recompute the steps from the checkpoints
+  if (nrx_ > 0 && !ckp_fwd_.empty()) casadi_copy(m->u, nu_, m->u_tape + nu_ * m->k);
+
   // Take steps
   for (casadi_int j = 0; j < nj; ++j) {
     // Current time
@@ -2058,12 +2365,26 @@ int FixedStepIntegrator::advance_noevent(IntegratorMemory* mem) const {
     casadi_copy(m->v, nv_, m->v_prev);
     casadi_copy(m->q, nq_, m->q_prev);
 
+    // Store the state before the step if at a checkpoint, in the slot given by the schedule
+    if (nrx_ > 0 && !ckp_fwd_.empty()) {
+      casadi_int tapeind = disc_[m->k] + j;
+      auto it = std::lower_bound(ckp_fwd_.begin(), ckp_fwd_.end(), tapeind);
+      if (it != ckp_fwd_.end() && *it == tapeind) {
+        casadi_int slot = it - ckp_fwd_.begin();
+        casadi_copy(x_prev, nx_, m->x_tape + nx_ * slot);
+        casadi_copy(m->v_prev, nv_, m->v_tape + nv_ * slot);
+        m->ckp_ind[slot] = tapeind;
+        m->n_ckp = slot + 1;
+      }
+    }
+
     // Take step
     stepF(m, t, h, x_prev, m->v_prev, m->x, m->v, m->q);
     casadi_axpy(nq_, 1., m->q_prev, m->q);
+    m->nsteps++;
 
     // Save state, if needed
-    if (nrx_ > 0) {
+    if (nrx_ > 0 && ckp_fwd_.empty()) {
       casadi_int tapeind = disc_[m->k] + j;
       casadi_copy(m->x, nx_, m->x_tape + nx_ * (tapeind + 1));
       casadi_copy(m->v, nv_, m->v_tape + nv_ * tapeind);
@@ -2097,12 +2418,20 @@ void FixedStepIntegrator::retreat(IntegratorMemory* mem, const double* u,
     casadi_copy(m->adj_p, nrq_, m->adj_p_prev);
     casadi_copy(m->adj_u, nuq_, m->adj_u_prev);
 
-    // Take step
+    // States before and after the step
     casadi_int tapeind = disc_[m->k] + j;
-    stepB(m, t, h,
-      m->x_tape + nx_ * tapeind, m->x_tape + nx_ * (tapeind + 1),
-      m->v_tape + nv_ * tapeind,
-      m->tmp1, m->rv, m->adj_x, m->adj_p, m->adj_u);
+    const double *x0, *xf, *vf;
+    if (ckp_fwd_.empty()) {
+      x0 = m->x_tape + nx_ * tapeind;
+      xf = m->x_tape + nx_ * (tapeind + 1);
+      vf = m->v_tape + nv_ * tapeind;
+    } else {
+      restore_step(m, tapeind, x0, xf, vf);
+      casadi_copy(u, nu_, m->u);
+    }
+
+    // Take step
+    stepB(m, t, h, x0, xf, vf, m->tmp1, m->rv, m->adj_x, m->adj_p, m->adj_u);
     casadi_clear(m->rv, nrv_);
     casadi_axpy(nrq_, 1., m->adj_p_prev, m->adj_p);
     casadi_axpy(nuq_, 1., m->adj_u_prev, m->adj_u);
@@ -2114,6 +2443,51 @@ void FixedStepIntegrator::retreat(IntegratorMemory* mem, const double* u,
   casadi_copy(m->adj_u, nuq_, adj_u);
 }
 
+void FixedStepIntegrator::restore_step(FixedStepMemory* m, casadi_int ind,
+    const double*& x0, const double*& xf, const double*& vf) const {
+  // Checkpoints past the step are no longer needed
+  while (m->ckp_ind[m->n_ckp - 1] > ind) m->n_ckp--;
+
+  // Start from the last checkpoint
+  casadi_int c0 = m->ckp_ind[m->n_ckp - 1];
+  double *x = m->x_rec, *v = m->v_rec, *x_next = m->x_rec2, *v_next = m->v_rec2;
+  casadi_copy(m->x_tape + nx_ * (m->n_ckp - 1), nx_, x);
+  casadi_copy(m->v_tape + nv_ * (m->n_ckp - 1), nv_, v);
+
+  // Step forward until after the step, storing checkpoints on the way while any are free
+  casadi_int c_store = c0;
+  for (casadi_int c = c0; c <= ind; ++c) {
+    if (c == c_store) {
+      if (c > c0) {
+        casadi_copy(x, nx_, m->x_tape + nx_ * m->n_ckp);
+        casadi_copy(v, nv_, m->v_tape + nv_ * m->n_ckp);
+        m->ckp_ind[m->n_ckp++] = c;
+      }
+      // Position of the next checkpoint, no need to store the state at the step itself
+      c_store = -1;
+      if (c < ind && m->n_ckp < checkpoints_) {
+        c_store = revolve_advance(c, ind + 1, checkpoints_ - m->n_ckp + 1);
+        if (c_store >= ind) c_store = -1;
+      }
+    }
+
+    // Control interval of the step
+    casadi_int k = std::upper_bound(disc_.begin(), disc_.end(), c) - disc_.begin() - 1;
+    double t_start = k == 0 ? t0_ : tout_[k - 1];
+    double h = (tout_[k] - t_start) / static_cast<double>(disc_[k + 1] - disc_[k]);
+    casadi_copy(m->u_tape + nu_ * k, nu_, m->u);
+
+    // Recompute step
+    stepF(m, t_start + static_cast<double>(c - disc_[k]) * h, h, x, v, x_next, v_next, m->q_rec);
+    if (c == ind) break;
+    std::swap(x, x_next);
+    std::swap(v, v_next);
+  }
+  x0 = x;
+  xf = x_next;
+  vf = v_next;
+}
+
 void FixedStepIntegrator::stepF(FixedStepMemory* m, double t, double h,
     const double* x0, const double* v0, double* xf, double* vf, double* qf) const {
   // Evaluate nondifferentiated
@@ -2218,6 +2592,21 @@ void FixedStepIntegrator::reset(IntegratorMemory* mem, bool first_call) const {
     if (nrx_ > 0) {
       casadi_copy(m->x, nx_, m->x_tape);
     }
+
+    // Reset the step counter
+    m->nsteps = 0;
+  }
+
+  // Dense output: uniform steps until the next step change in the controls
+  if (dense_output_) {
+    casadi_copy(m->x, nx_, m->x_step);
+    casadi_copy(m->q, nq_, m->q_step);
+    m->t_seg = m->t;
+    m->k_step = 0;
+    double h_target = (tout_.back() - t0_) / nk_target_;
+    m->n_step = static_cast<casadi_int>(std::ceil((m->t_stop - m->t) / h_target - 1e-9));
+    m->h_step = m->n_step > 0 ? (m->t_stop - m->t) / m->n_step : 0;
+    if (m->n_step > 0) calc_deriv(m, m->t, m->x_step, m->xdot_step, m->qdot_step);
   }
 }
 
@@ -2288,6 +2677,8 @@ void ImplicitFixedStepIntegrator::init(const Dict& opts) {
   // Complete rootfinder dictionary
   rootfinder_options["implicit_input"] = STEP_V0;
   rootfinder_options["implicit_output"] = STEP_VF;
+  rootfinder_plugin_ = implicit_function_name;
+  rootfinder_options_ = rootfinder_options;
 
   // Allocate a solver
   Function rf = rootfinder("step", implicit_function_name,
@@ -2480,8 +2871,11 @@ Integrator::Integrator(DeserializingStream & s) : OracleFunction(s) {
 void FixedStepIntegrator::serialize_body(SerializingStream &s) const {
   Integrator::serialize_body(s);
 
-  s.version("FixedStepIntegrator", 3);
+  s.version("FixedStepIntegrator", 5);
   s.pack("FixedStepIntegrator::nk_target", nk_target_);
+  s.pack("FixedStepIntegrator::checkpoints", checkpoints_);
+  s.pack("FixedStepIntegrator::ckp_fwd", ckp_fwd_);
+  s.pack("FixedStepIntegrator::dense_output", dense_output_);
   s.pack("FixedStepIntegrator::disc", disc_);
   s.pack("FixedStepIntegrator::nv", nv_);
   s.pack("FixedStepIntegrator::nv1", nv1_);
@@ -2490,8 +2884,19 @@ void FixedStepIntegrator::serialize_body(SerializingStream &s) const {
 }
 
 FixedStepIntegrator::FixedStepIntegrator(DeserializingStream & s) : Integrator(s) {
-  s.version("FixedStepIntegrator", 3);
+  int version = s.version("FixedStepIntegrator", 3, 5);
   s.unpack("FixedStepIntegrator::nk_target", nk_target_);
+  if (version >= 4) {
+    s.unpack("FixedStepIntegrator::checkpoints", checkpoints_);
+    s.unpack("FixedStepIntegrator::ckp_fwd", ckp_fwd_);
+  } else {
+    checkpoints_ = -1;
+  }
+  if (version >= 5) {
+    s.unpack("FixedStepIntegrator::dense_output", dense_output_);
+  } else {
+    dense_output_ = false;
+  }
   s.unpack("FixedStepIntegrator::disc", disc_);
   s.unpack("FixedStepIntegrator::nv", nv_);
   s.unpack("FixedStepIntegrator::nv1", nv1_);
@@ -2499,15 +2904,53 @@ FixedStepIntegrator::FixedStepIntegrator(DeserializingStream & s) : Integrator(s
   s.unpack("FixedStepIntegrator::nrv1", nrv1_);
 }
 
+Function ImplicitFixedStepIntegrator::batch_step(casadi_int n) const {
+  // Residual for all trajectories, vectorized if the dynamics are in SX form
+  Function G = get_function("implicit_step");
+  if (oracle_.is_a("SXFunction")) G = G.expand();
+  G = G.map(n, G.is_a("SXFunction") ? "simd" : "serial");
+
+  // Same time and step size for all trajectories
+  std::vector<MX> G_in = G.mx_in();
+  G_in[STEP_T] = MX::sym("t");
+  G_in[STEP_H] = MX::sym("h");
+
+  // Residual in the stacked dependent variables, with a block diagonal Jacobian
+  std::vector<MX> Gv_in = G_in;
+  Gv_in[STEP_V0] = MX::sym("v0", G.nnz_in(STEP_V0));
+  G_in[STEP_V0] = reshape(Gv_in[STEP_V0], G.size_in(STEP_V0));
+  std::vector<MX> Gv_out = G(G_in);
+  Gv_out[STEP_VF] = vec(Gv_out[STEP_VF]);
+  Function Gv("implicit_step_batch", Gv_in, Gv_out,
+    {"t", "h", "x0", "v0", "p", "u"}, {"xf", "vf", "qf"});
+
+  // One Newton iteration for all trajectories
+  Function rf = rootfinder("step_batch_rf", rootfinder_plugin_, Gv, rootfinder_options_);
+  std::vector<MX> F_in = G_in;
+  F_in[STEP_V0] = MX::sym("v0", G.sparsity_in(STEP_V0));
+  std::vector<MX> rf_in = F_in;
+  rf_in[STEP_V0] = vec(F_in[STEP_V0]);
+  std::vector<MX> F_out = rf(rf_in);
+  F_out[STEP_VF] = reshape(F_out[STEP_VF], G.size_in(STEP_V0));
+  return Function("step_batch", F_in, F_out,
+    {"t", "h", "x0", "v0", "p", "u"}, {"xf", "vf", "qf"});
+}
+
 void ImplicitFixedStepIntegrator::serialize_body(SerializingStream &s) const {
   FixedStepIntegrator::serialize_body(s);
 
-  s.version("ImplicitFixedStepIntegrator", 2);
+  s.version("ImplicitFixedStepIntegrator", 3);
+  s.pack("ImplicitFixedStepIntegrator::rootfinder_plugin", rootfinder_plugin_);
+  s.pack("ImplicitFixedStepIntegrator::rootfinder_options", rootfinder_options_);
 }
 
 ImplicitFixedStepIntegrator::ImplicitFixedStepIntegrator(DeserializingStream & s) :
     FixedStepIntegrator(s) {
-  s.version("ImplicitFixedStepIntegrator", 2);
+  int version = s.version("ImplicitFixedStepIntegrator", 2, 3);
+  if (version >= 3) {
+    s.unpack("ImplicitFixedStepIntegrator::rootfinder_plugin", rootfinder_plugin_);
+    s.unpack("ImplicitFixedStepIntegrator::rootfinder_options", rootfinder_options_);
+  }
 }
 
 void Integrator::set_q(IntegratorMemory* m, const double* q) const {
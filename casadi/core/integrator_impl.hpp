@@ -559,8 +559,25 @@ struct CASADI_EXPORT FixedStepMemory : public IntegratorMemory {
   /// Work vectors, backward problem
   double *rv, *adj_u, *adj_p_prev, *adj_u_prev;
 
-  /// State and dependent variables at all times
+  /// State and dependent variables at all times, or at the checkpoints only
   double *x_tape, *v_tape;
+
+  /// Checkpointing: step index of each stored checkpoint and number stored
+  casadi_int *ckp_ind, n_ckp;
+
+  /// Checkpointing: controls for each interval and recomputed states
+  double *u_tape, *x_rec, *v_rec, *x_rec2, *v_rec2, *q_rec;
+
+  /// Dense output: states, quadratures and time derivatives at the last two step boundaries
+  double *x_step, *x_step_prev, *q_step, *q_step_prev;
+  double *xdot_step, *xdot_step_prev, *qdot_step, *qdot_step_prev;
+
+  /// Dense output: steps taken and in total since the last reset, start time and step size
+  casadi_int k_step, n_step;
+  double t_seg, h_step;
+
+  /// Number of steps taken in the forward integration
+  casadi_int nsteps;
 };
 
 class CASADI_EXPORT FixedStepIntegrator : public Integrator {
@@ -593,6 +610,19 @@ class CASADI_EXPORT FixedStepIntegrator : public Integrator {
   /** Helper for a more powerful 'integrator' factory */
   Function create_advanced(const Dict& opts) override;
 
+  /** \brief Integrate n trajectories in lockstep, as an MX Function
+
+      Inputs and outputs are as for map(n) on the integrator.
+   */
+  Function create_batch(const std::string& name, casadi_int n, const Dict& opts) const;
+
+  /** \brief Discrete time dynamics for n trajectories
+
+      Same signature as the "step" function, with one column per trajectory
+      for all inputs except the time and step size.
+   */
+  virtual Function batch_step(casadi_int n) const;
+
   /** \brief Create memory block
 
       \identifier{1mj} */
@@ -608,6 +638,9 @@ class CASADI_EXPORT FixedStepIntegrator : public Integrator {
       \identifier{1ml} */
   void free_mem(void *mem) const override { delete static_cast<FixedStepMemory*>(mem);}
 
+  /// Get all statistics
+  Dict get_stats(void* mem) const override;
+
   /// Setup step functions
   virtual void setup_step() = 0;
 
@@ -644,9 +677,37 @@ class CASADI_EXPORT FixedStepIntegrator : public Integrator {
     const double* adj_xf, const double* rv0,
     double* adj_x0, double* adj_p, double* adj_u) const;
 
+  /** \brief Take steps until the next output time and interpolate the solution there
+
+      Cubic Hermite interpolation between the states and quadratures at the
+      ends of the step, using their time derivatives from the DAE.
+   */
+  void advance_dense(FixedStepMemory* m) const;
+
+  /// Time derivatives of the state and quadratures, with forward sensitivities
+  void calc_deriv(FixedStepMemory* m, double t, const double* x,
+    double* xdot, double* qdot) const;
+
+  /** \brief Recompute the states before and after a step from the checkpoints
+
+      Checkpoints past the step are discarded and new ones are stored on the way,
+      following the binomial (revolve) schedule for the free checkpoints.
+   */
+  void restore_step(FixedStepMemory* m, casadi_int ind,
+    const double*& x0, const double*& xf, const double*& vf) const;
+
   // Target number of finite elements
   casadi_int nk_target_;
 
+  // Number of states stored for the adjoint sweep, -1 if all are stored
+  casadi_int checkpoints_;
+
+  // Steps at which the forward sweep stores checkpoints, empty if all are stored
+  std::vector<casadi_int> ckp_fwd_;
+
+  // Step independently of the output times, interpolating the outputs
+  bool dense_output_;
+
   // Number of steps per control interval
   std::vector<casadi_int> disc_;
 
@@ -686,6 +747,13 @@ class CASADI_EXPORT ImplicitFixedStepIntegrator : public FixedStepIntegrator {
   /// Initialize stage
   void init(const Dict& opts) override;
 
+  /// Discrete time dynamics for n trajectories, with one Newton iteration for all
+  Function batch_step(casadi_int n) const override;
+
+  // Rootfinder plugin and options for the implicit step
+  std::string rootfinder_plugin_;
+  Dict rootfinder_options_;
+
   /** \brief Serialize an object without type information
 
       \identifier{1ms} */
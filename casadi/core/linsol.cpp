@@ -114,6 +114,7 @@ namespace casadi {
     // Factorization will be needed after this step
     m->is_sfact = m->is_nfact = false;
 
+    TraceScope trace((*this)->trace_sfact_, (*this)->name_, m->mem_id, ".sfact");
     if (m->t_total) m->fstats.at("sfact").tic();
     // Perform pivoting
     if ((*this)->sfact(m, A)) return 1;
@@ -140,7 +141,11 @@ namespace casadi {
 
     m->is_nfact = false;
     if (m->t_total) m->fstats.at("nfact").tic();
-    int flag = (*this)->nfact(m, A);
+    int flag;
+    {
+      TraceScope trace((*this)->trace_nfact_, (*this)->name_, m->mem_id, ".nfact");
+      flag = (*this)->nfact(m, A);
+    }
     if (m->t_total) m->fstats.at("nfact").toc();
     if (flag && (*this)->regularity_check_) {
       // Collect nonzeros
@@ -188,6 +193,7 @@ namespace casadi {
   int Linsol::solve(const double* A, double* x, casadi_int nrhs, bool tr, int mem) const {
     auto m = static_cast<LinsolMemory*>((*this)->memory(mem));
     casadi_assert(m->is_nfact, "Linear system has not been factorized");
+    TraceScope trace((*this)->trace_solve_, (*this)->name_, m->mem_id, ".solve");
     if (m->t_total) m->fstats.at("solve").tic();
     int ret = (*this)->solve(m, A, x, nrhs, tr);
     if (m->t_total) m->fstats.at("solve").toc();
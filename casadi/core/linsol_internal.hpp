@@ -160,6 +160,9 @@ namespace casadi {
     // Sparsity pattern of the linear system
     Sparsity sp_;
 
+    /// Names of factorization and solve events, see TraceRecorder
+    TraceName trace_sfact_, trace_nfact_, trace_solve_;
+
   protected:
     /** \brief Deserializing constructor
 
@@ -25,6 +25,8 @@
 
 #include "map.hpp"
 #include "serializing_stream.hpp"
+#include "thread_pool.hpp"
+#include "sx_function.hpp"
 
 #ifdef CASADI_WITH_THREAD
 #ifdef CASADI_WITH_THREAD_MINGW
@@ -36,15 +38,20 @@
 
 namespace casadi {
 
-  Function Map::create(const std::string& parallelization, const Function& f, casadi_int n) {
+  Function Map::create(const std::string& parallelization, const Function& f, casadi_int n,
+      const Dict& opts) {
     // Create instance of the right class
     std::string suffix = str(n) + "_" + f.name();
     if (parallelization == "serial") {
-      return Function::create(new Map("map" + suffix, f, n), Dict());
+      return Function::create(new Map("map" + suffix, f, n), opts);
     } else if (parallelization== "openmp") {
-      return Function::create(new OmpMap("ompmap" + suffix, f, n), Dict());
+      return Function::create(new OmpMap("ompmap" + suffix, f, n), opts);
     } else if (parallelization== "thread") {
-      return Function::create(new ThreadMap("threadmap" + suffix, f, n), Dict());
+      return Function::create(new ThreadMap("threadmap" + suffix, f, n), opts);
+    } else if (parallelization== "thread_pool") {
+      return Function::create(new ThreadPoolMap("threadpoolmap" + suffix, f, n), opts);
+    } else if (parallelization== "simd") {
+      return Function::create(new SimdMap("simdmap" + suffix, f, n), opts);
     } else {
       casadi_error("Unknown parallelization: " + parallelization);
     }
@@ -69,6 +76,16 @@ namespace casadi {
       || (recursive && Map::is_a(type, recursive));
   }
 
+  bool ThreadPoolMap::is_a(const std::string& type, bool recursive) const {
+    return type=="ThreadPoolMap"
+      || (recursive && Map::is_a(type, recursive));
+  }
+
+  bool SimdMap::is_a(const std::string& type, bool recursive) const {
+    return type=="SimdMap"
+      || (recursive && Map::is_a(type, recursive));
+  }
+
  std::vector<std::string> Map::get_function() const {
     return {"f"};
   }
@@ -109,6 +126,10 @@ namespace casadi {
       return new OmpMap(s);
     } else if (class_name=="ThreadMap") {
       return new ThreadMap(s);
+    } else if (class_name=="ThreadPoolMap") {
+      return new ThreadPoolMap(s);
+    } else if (class_name=="SimdMap") {
+      return new SimdMap(s);
     } else {
       casadi_error("class name '" + class_name + "' unknown.");
     }
@@ -522,4 +543,265 @@ namespace casadi {
     alloc_iw(f_.sz_iw() * n_);
   }
 
+  ThreadPoolMap::~ThreadPoolMap() {
+    clear_mem();
+  }
+
+  const Options ThreadPoolMap::options_
+  = {{&FunctionInternal::options_},
+     {{"num_threads",
+       {OT_INT,
+        "Number of workers, each with its own work vectors and memory object "
+        "[default: size of the thread pool]"}},
+      {"chunk_size",
+       {OT_INT,
+        "Number of consecutive map iterations claimed by a worker at once "
+        "[default: 1 with work stealing, otherwise n divided by the number of workers]"}},
+      {"work_stealing",
+       {OT_BOOL,
+        "Let workers that run out of iterations take over iterations of other workers "
+        "[default: true]"}}
+     }
+  };
+
+  void ThreadPoolMap::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    Map::init(opts);
+
+    // Default options
+    n_worker_ = ThreadPool::global().size();
+    chunk_size_ = -1;
+    work_stealing_ = true;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="num_threads") {
+        n_worker_ = op.second;
+      } else if (op.first=="chunk_size") {
+        chunk_size_ = op.second;
+      } else if (op.first=="work_stealing") {
+        work_stealing_ = op.second;
+      }
+    }
+    casadi_assert(n_worker_>=1, "Option 'num_threads' must be positive");
+    n_worker_ = std::min(n_worker_, n_);
+    if (chunk_size_<0) chunk_size_ = work_stealing_ ? 1 : (n_ + n_worker_ - 1) / n_worker_;
+    casadi_assert(chunk_size_>=1, "Option 'chunk_size' must be positive");
+
+    // Allocate sufficient memory for parallel evaluation
+    alloc_arg(f_.sz_arg() * n_worker_);
+    alloc_res(f_.sz_res() * n_worker_);
+    alloc_w(f_.sz_w() * n_worker_);
+    alloc_iw(f_.sz_iw() * n_worker_);
+  }
+
+  int ThreadPoolMap::init_mem(void* mem) const {
+    if (Map::init_mem(mem)) return 1;
+    auto m = static_cast<ThreadPoolMapMemory*>(mem);
+    m->range = std::vector<ThreadPoolMapMemory::Range>(n_worker_);
+    // Checkout memory objects once and for all
+    m->f_mem.resize(n_worker_);
+    for (int& e : m->f_mem) e = f_.checkout();
+    return 0;
+  }
+
+  void ThreadPoolMap::free_mem(void *mem) const {
+    auto m = static_cast<ThreadPoolMapMemory*>(mem);
+    for (int e : m->f_mem) f_.release(e);
+    delete m;
+  }
+
+  int ThreadPoolMap::eval_range(const double** arg, double** res, casadi_int* iw, double* w,
+      ThreadPoolMapMemory* m, casadi_int worker, casadi_int begin, casadi_int end) const {
+    // Function work sizes
+    size_t sz_arg, sz_res, sz_iw, sz_w;
+    f_.sz_work(sz_arg, sz_res, sz_iw, sz_w);
+    // Input buffers
+    const double** arg1 = arg + n_in_ + worker*sz_arg;
+    for (casadi_int j=0; j<n_in_; ++j) {
+      arg1[j] = arg[j] ? arg[j] + begin*f_.nnz_in(j) : nullptr;
+    }
+    // Output buffers
+    double** res1 = res + n_out_ + worker*sz_res;
+    for (casadi_int j=0; j<n_out_; ++j) {
+      res1[j] = res[j] ? res[j] + begin*f_.nnz_out(j) : nullptr;
+    }
+    // Evaluate serially
+    for (casadi_int i=begin; i<end; ++i) {
+      if (f_(arg1, res1, iw + worker*sz_iw, w + worker*sz_w, m->f_mem[worker])) return 1;
+      for (casadi_int j=0; j<n_in_; ++j) {
+        if (arg1[j]) arg1[j] += f_.nnz_in(j);
+      }
+      for (casadi_int j=0; j<n_out_; ++j) {
+        if (res1[j]) res1[j] += f_.nnz_out(j);
+      }
+    }
+    return 0;
+  }
+
+  bool ThreadPoolMap::claim(ThreadPoolMapMemory* m, casadi_int worker,
+      casadi_int& begin, casadi_int& end) const {
+    ThreadPoolMapMemory::Range& r = m->range[worker];
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(r.mtx);
+#endif // CASADI_WITH_THREAD
+    if (r.begin==r.end) return false;
+    begin = r.begin;
+    end = r.begin = std::min(r.begin + chunk_size_, r.end);
+    return true;
+  }
+
+  bool ThreadPoolMap::steal(ThreadPoolMapMemory* m, casadi_int worker) const {
+    while (true) {
+      // Find the worker with the most remaining iterations
+      casadi_int victim = -1, max_rem = 0;
+      for (casadi_int k=0; k<n_worker_; ++k) {
+        if (k==worker) continue;
+        ThreadPoolMapMemory::Range& r = m->range[k];
+#ifdef CASADI_WITH_THREAD
+        std::lock_guard<std::mutex> lock(r.mtx);
+#endif // CASADI_WITH_THREAD
+        if (r.end - r.begin > max_rem) {
+          max_rem = r.end - r.begin;
+          victim = k;
+        }
+      }
+      // Nothing left to do
+      if (victim<0) return false;
+      // Take the second half, the range may have shrunk in the meantime
+      casadi_int begin, end;
+      {
+        ThreadPoolMapMemory::Range& r = m->range[victim];
+#ifdef CASADI_WITH_THREAD
+        std::lock_guard<std::mutex> lock(r.mtx);
+#endif // CASADI_WITH_THREAD
+        if (r.begin==r.end) continue;
+        end = r.end;
+        begin = r.end = r.end - (r.end - r.begin + 1) / 2;
+      }
+      // Make the iterations available to the thief (and to other thieves)
+      ThreadPoolMapMemory::Range& r = m->range[worker];
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(r.mtx);
+#endif // CASADI_WITH_THREAD
+      r.begin = begin;
+      r.end = end;
+      return true;
+    }
+  }
+
+  int ThreadPoolMap::eval(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem) const {
+    setup(mem, arg, res, iw, w);
+    auto m = static_cast<ThreadPoolMapMemory*>(mem);
+
+    // Distribute iterations evenly in contiguous blocks
+    for (casadi_int k=0; k<n_worker_; ++k) {
+      m->range[k].begin = (k*n_) / n_worker_;
+      m->range[k].end = ((k+1)*n_) / n_worker_;
+    }
+
+    // One task per worker
+    return ThreadPool::global().run(n_worker_, [&](casadi_int worker) -> int {
+      casadi_int begin, end;
+      while (true) {
+        if (claim(m, worker, begin, end)) {
+          if (eval_range(arg, res, iw, w, m, worker, begin, end)) return 1;
+        } else if (!work_stealing_ || !steal(m, worker)) {
+          return 0;
+        }
+      }
+    });
+  }
+
+  void ThreadPoolMap::codegen_body(CodeGenerator& g) const {
+    Map::codegen_body(g);
+  }
+
+  void ThreadPoolMap::serialize_body(SerializingStream &s) const {
+    Map::serialize_body(s);
+    s.pack("ThreadPoolMap::n_worker", n_worker_);
+    s.pack("ThreadPoolMap::chunk_size", chunk_size_);
+    s.pack("ThreadPoolMap::work_stealing", work_stealing_);
+  }
+
+  ThreadPoolMap::ThreadPoolMap(DeserializingStream& s) : Map(s) {
+    s.unpack("ThreadPoolMap::n_worker", n_worker_);
+    s.unpack("ThreadPoolMap::chunk_size", chunk_size_);
+    s.unpack("ThreadPoolMap::work_stealing", work_stealing_);
+  }
+
+  SimdMap::~SimdMap() {
+    clear_mem();
+  }
+
+  const Options SimdMap::options_
+  = {{&FunctionInternal::options_},
+     {{"vector_width",
+       {OT_INT,
+        "Number of map iterations evaluated in a single pass over the algorithm "
+        "[default: 8]"}}
+     }
+  };
+
+  void SimdMap::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    Map::init(opts);
+
+    // Default options
+    vector_width_ = 8;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="vector_width") {
+        vector_width_ = op.second;
+      }
+    }
+    casadi_assert(vector_width_>=1, "Option 'vector_width' must be positive");
+    vector_width_ = std::min(vector_width_, n_);
+
+    // Batched evaluation only for SX-based functions without call nodes
+    const SXFunction* sf = f_.is_a("SXFunction") ? f_.get<SXFunction>() : nullptr;
+    has_lanes_ = sf && sf->has_eval_lanes();
+    if (!has_lanes_) {
+      casadi_warning("Batched evaluation requires an SXFunction without call nodes. "
+                     "Falling back to serial evaluation.");
+      return;
+    }
+
+    // Work vector holding all lanes
+    alloc_w(sf->sz_w_lanes(vector_width_));
+  }
+
+  int SimdMap::eval(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem) const {
+    if (!has_lanes_) return Map::eval(arg, res, iw, w, mem);
+    setup(mem, arg, res, iw, w);
+    const SXFunction* sf = f_.get<SXFunction>();
+    // Input and output buffers
+    const double** arg1 = arg + n_in_;
+    double** res1 = res + n_out_;
+    for (casadi_int i=0; i<n_; i+=vector_width_) {
+      for (casadi_int j=0; j<n_in_; ++j) {
+        arg1[j] = arg[j] ? arg[j] + i*f_.nnz_in(j) : nullptr;
+      }
+      for (casadi_int j=0; j<n_out_; ++j) {
+        res1[j] = res[j] ? res[j] + i*f_.nnz_out(j) : nullptr;
+      }
+      if (sf->eval_lanes(arg1, res1, w, std::min(vector_width_, n_ - i))) return 1;
+    }
+    return 0;
+  }
+
+  void SimdMap::serialize_body(SerializingStream &s) const {
+    Map::serialize_body(s);
+    s.pack("SimdMap::vector_width", vector_width_);
+    s.pack("SimdMap::has_lanes", has_lanes_);
+  }
+
+  SimdMap::SimdMap(DeserializingStream& s) : Map(s) {
+    s.unpack("SimdMap::vector_width", vector_width_);
+    s.unpack("SimdMap::has_lanes", has_lanes_);
+  }
+
 } // namespace casadi
@@ -40,7 +40,7 @@ namespace casadi {
   public:
     // Create function (use instead of constructor)
     static Function create(const std::string& parallelization,
-                           const Function& f, casadi_int n);
+                           const Function& f, casadi_int n, const Dict& opts=Dict());
 
     /** \brief Destructor
 
@@ -317,6 +317,154 @@ namespace casadi {
     explicit ThreadMap(DeserializingStream& s) : Map(s) {}
   };
 
+  /** \brief Memory for ThreadPoolMap
+
+      Memory objects of the mapped function are checked out once per worker
+      and held for the lifetime of the memory object
+  */
+  struct CASADI_EXPORT ThreadPoolMapMemory : public FunctionMemory {
+    // Range of map iterations not yet claimed by a worker
+    struct Range {
+      casadi_int begin, end;
+#ifdef CASADI_WITH_THREAD
+      std::mutex mtx;
+#endif // CASADI_WITH_THREAD
+    };
+    // Remaining iterations, one range per worker
+    std::vector<Range> range;
+    // Memory objects of f_, one per worker
+    std::vector<int> f_mem;
+  };
+
+  /** A map Evaluate in parallel using a persistent pool of worker threads
+
+      Contrary to ThreadMap, no threads are created during evaluation.
+      Each worker has its own work vectors, so that memory use scales with the
+      number of workers rather than with n. The iterations are initially
+      distributed in contiguous blocks and claimed in chunks; a worker that
+      runs out of iterations steals half of the largest remaining block.
+  */
+  class CASADI_EXPORT ThreadPoolMap : public Map {
+    friend class Map;
+  public:
+    // Constructor (protected, use create function in Map)
+    ThreadPoolMap(const std::string& name, const Function& f, casadi_int n) : Map(name, f, n) {}
+
+    /** \brief  Destructor */
+    ~ThreadPoolMap() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "ThreadPoolMap";}
+
+    /** \brief Check if the function is of a particular type */
+    bool is_a(const std::string& type, bool recursive) const override;
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new ThreadPoolMapMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override;
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    /// Type of parallellization
+    std::string parallelization() const override { return "thread_pool"; }
+
+    /** \brief Generate code for the body of the C function */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit ThreadPoolMap(DeserializingStream& s);
+
+    // Evaluate the iterations [begin, end) using the work vectors of a worker
+    int eval_range(const double** arg, double** res, casadi_int* iw, double* w,
+      ThreadPoolMapMemory* m, casadi_int worker, casadi_int begin, casadi_int end) const;
+
+    // Claim a chunk of iterations from the range of a worker
+    bool claim(ThreadPoolMapMemory* m, casadi_int worker,
+      casadi_int& begin, casadi_int& end) const;
+
+    // Move half of the largest remaining range to a worker that ran out
+    bool steal(ThreadPoolMapMemory* m, casadi_int worker) const;
+
+    // Number of workers, each with its own work vectors
+    casadi_int n_worker_;
+
+    // Number of map iterations claimed at once
+    casadi_int chunk_size_;
+
+    // Balance load between workers at runtime
+    bool work_stealing_;
+  };
+
+  /** A map Evaluate SX-based functions for several points at once
+
+      Each slot of the work vector of the mapped SXFunction holds one value per lane,
+      so that a single pass over the algorithm evaluates up to "vector_width" map
+      iterations, with each instruction applied in a loop over the lanes that the
+      compiler can vectorize. Falls back to serial evaluation for other functions.
+  */
+  class CASADI_EXPORT SimdMap : public Map {
+    friend class Map;
+  public:
+    // Constructor (protected, use create function in Map)
+    SimdMap(const std::string& name, const Function& f, casadi_int n) : Map(name, f, n) {}
+
+    /** \brief  Destructor */
+    ~SimdMap() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "SimdMap";}
+
+    /** \brief Check if the function is of a particular type */
+    bool is_a(const std::string& type, bool recursive) const override;
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    /// Type of parallellization
+    std::string parallelization() const override { return "simd"; }
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit SimdMap(DeserializingStream& s);
+
+    // Number of map iterations evaluated in one pass
+    casadi_int vector_width_;
+
+    // Batched evaluation possible
+    bool has_lanes_;
+  };
+
 } // namespace casadi
 /// \endcond
 
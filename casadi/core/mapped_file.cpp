@@ -0,0 +1,111 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "mapped_file.hpp"
+
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CASADI_MAPPED_FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace casadi {
+
+  MappedFile::MappedFile(const std::string& fname)
+      : data_(nullptr), size_(0), open_(false), mapped_(false) {
+#ifdef CASADI_MAPPED_FILE_MMAP
+    int fd = ::open(fname.c_str(), O_RDONLY);
+    if (fd>=0) {
+      struct stat st;
+      if (fstat(fd, &st)==0 && S_ISREG(st.st_mode)) {
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_==0) {
+          open_ = true;
+        } else {
+          void* p = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+          if (p!=MAP_FAILED) {
+            data_ = static_cast<char*>(p);
+            open_ = mapped_ = true;
+            // Deserialization reads the file front to back
+            madvise(p, size_, MADV_SEQUENTIAL);
+          }
+        }
+      }
+      // The mapping stays valid after closing the file
+      ::close(fd);
+    }
+#endif // CASADI_MAPPED_FILE_MMAP
+    if (!open_) {
+      // Read into memory instead
+      std::ifstream f(fname, std::ios_base::binary | std::ios_base::in);
+      if (f.good()) {
+        buffer_.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        data_ = buffer_.empty() ? nullptr : &buffer_.front();
+        size_ = buffer_.size();
+        open_ = true;
+      }
+    }
+    // The whole file is the get area, streambuf::xsgetn copies from it in bulk
+    setg(data_, data_, data_ + size_);
+  }
+
+  MappedFile::~MappedFile() {
+#ifdef CASADI_MAPPED_FILE_MMAP
+    if (mapped_) munmap(data_, size_);
+#endif // CASADI_MAPPED_FILE_MMAP
+  }
+
+  MappedFile::pos_type MappedFile::seekoff(off_type off, std::ios_base::seekdir dir,
+      std::ios_base::openmode which) {
+    if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+    off_type pos;
+    if (dir==std::ios_base::beg) {
+      pos = off;
+    } else if (dir==std::ios_base::cur) {
+      pos = (gptr() - eback()) + off;
+    } else {
+      pos = static_cast<off_type>(size_) + off;
+    }
+    if (pos<0 || pos>static_cast<off_type>(size_)) return pos_type(off_type(-1));
+    setg(eback(), eback() + pos, egptr());
+    return pos_type(pos);
+  }
+
+  MappedFile::pos_type MappedFile::seekpos(pos_type pos, std::ios_base::openmode which) {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+
+  MappedIStream::MappedIStream(const std::string& fname)
+      : std::istream(nullptr), file_(fname) {
+    rdbuf(&file_);
+    if (!file_.is_open()) setstate(std::ios_base::failbit);
+  }
+
+} // namespace casadi
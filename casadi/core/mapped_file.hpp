@@ -0,0 +1,105 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_MAPPED_FILE_HPP
+#define CASADI_MAPPED_FILE_HPP
+
+#include "casadi_common.hpp"
+
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Read-only view of a file, memory-mapped where supported
+
+      Reading through the stream buffer copies directly from the mapped pages, which are
+      shared with all other processes mapping the same file via the page cache. Falls back
+      to reading the file into memory on platforms without mmap.
+
+      Limitation: the deserialized objects are copied out of the mapping into their own
+      heap storage, the mapping is not used in place. Only the file pages are shared, the
+      per-process memory of the loaded objects does not drop.
+
+      The mapping must not be truncated while it is read. FileSerializer (Function::save)
+      therefore replaces files atomically by renaming a temporary file over the target,
+      which leaves existing mappings of the old file intact.
+  */
+  class CASADI_EXPORT MappedFile : public std::streambuf {
+  public:
+    /// Map a file, check is_open for success
+    explicit MappedFile(const std::string& fname);
+
+    /// Destructor, unmaps the file
+    ~MappedFile() override;
+
+    /// Was the file opened successfully?
+    bool is_open() const { return open_;}
+
+    /// Is the file memory-mapped (as opposed to read into memory)?
+    bool is_mapped() const { return mapped_;}
+
+    /// File contents
+    const char* data() const { return data_;}
+
+    /// File size
+    size_t size() const { return size_;}
+
+  protected:
+    /// Random access, needed for tellg/seekg
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+  private:
+    // File contents
+    char* data_;
+    size_t size_;
+    // Status
+    bool open_, mapped_;
+    // Storage when not mapped
+    std::vector<char> buffer_;
+  };
+
+  /** \brief Input stream reading from a MappedFile
+  */
+  class CASADI_EXPORT MappedIStream : public std::istream {
+  public:
+    explicit MappedIStream(const std::string& fname);
+
+    /// Access the mapped file
+    const MappedFile& file() const { return file_;}
+  private:
+    MappedFile file_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_MAPPED_FILE_HPP
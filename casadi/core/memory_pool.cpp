@@ -0,0 +1,110 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "memory_pool.hpp"
+#include "exception.hpp"
+#include "casadi_misc.hpp"
+
+namespace casadi {
+
+  MemoryPool::MemoryPool() : size_(0), head_(0) {
+    for (int k=0; k<n_chunk; ++k) chunk_[k].store(nullptr, std::memory_order_relaxed);
+  }
+
+  MemoryPool::~MemoryPool() {
+    clear();
+  }
+
+  MemoryPool::Slot& MemoryPool::slot(int ind) const {
+    // Slot ind is entry ind+1-2^k of chunk k, with 2^k <= ind+1 < 2^(k+1)
+    uint32_t i = static_cast<uint32_t>(ind) + 1;
+    int k = 0;
+    while (i >> (k+1)) k++;
+    return chunk_[k].load(std::memory_order_acquire)[i - (uint32_t(1) << k)];
+  }
+
+  int MemoryPool::pop() {
+    uint64_t h = head_.load(std::memory_order_acquire);
+    while (true) {
+      uint32_t top = static_cast<uint32_t>(h);
+      if (top==0) return -1;
+      // Slots are never deallocated while in use, reading a stale link is harmless
+      uint32_t next = slot(top-1).next.load(std::memory_order_relaxed);
+      uint64_t h_new = ((h >> 32) + 1) << 32 | next;
+      if (head_.compare_exchange_weak(h, h_new, std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+        return static_cast<int>(top) - 1;
+      }
+    }
+  }
+
+  void MemoryPool::push(int ind) {
+    casadi_assert(ind>=0 && ind<size(), "Memory object " + str(ind) + " out of bounds");
+    Slot& s = slot(ind);
+    uint64_t h = head_.load(std::memory_order_relaxed);
+    while (true) {
+      s.next.store(static_cast<uint32_t>(h), std::memory_order_relaxed);
+      uint64_t h_new = ((h >> 32) + 1) << 32 | (static_cast<uint32_t>(ind) + 1);
+      if (head_.compare_exchange_weak(h, h_new, std::memory_order_acq_rel,
+                                      std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+  int MemoryPool::add(void* mem) {
+    int ind = size_.load(std::memory_order_relaxed);
+    uint32_t i = static_cast<uint32_t>(ind) + 1;
+    int k = 0;
+    while (i >> (k+1)) k++;
+    casadi_assert(k<n_chunk, "Too many memory objects");
+    // Allocate a new chunk, if needed
+    if (chunk_[k].load(std::memory_order_relaxed)==nullptr) {
+      Slot* c = new Slot[uint32_t(1) << k];
+      chunk_[k].store(c, std::memory_order_release);
+    }
+    Slot& s = slot(ind);
+    s.mem = mem;
+    s.next.store(0, std::memory_order_relaxed);
+    // Publish
+    size_.store(ind + 1, std::memory_order_release);
+    return ind;
+  }
+
+  void* MemoryPool::at(int ind) const {
+    casadi_assert(ind>=0 && ind<size(), "Memory object " + str(ind) + " out of bounds");
+    return slot(ind).mem;
+  }
+
+  void MemoryPool::clear() {
+    for (int k=0; k<n_chunk; ++k) {
+      delete[] chunk_[k].exchange(nullptr);
+    }
+    size_.store(0);
+    head_.store(0);
+  }
+
+} // namespace casadi
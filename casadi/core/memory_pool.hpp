@@ -0,0 +1,105 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_MEMORY_POOL_HPP
+#define CASADI_MEMORY_POOL_HPP
+
+#include "casadi_common.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Pool of memory objects with lock-free checkout and release
+
+      Memory objects are identified by their index. Released indices are kept in
+      a lock-free (Treiber) stack, tagged against ABA, so that checking out a
+      previously used memory object and releasing it never blocks. Slots are stored
+      in chunks of doubling size that never move, which makes look-up by index
+      lock-free as well. Appending a new memory object is not thread-safe and must
+      be serialized by the caller.
+  */
+  class CASADI_EXPORT MemoryPool {
+  public:
+    /// Constructor
+    MemoryPool();
+
+    /// Destructor, does not free the memory objects
+    ~MemoryPool();
+
+    /// Take an unused memory object, -1 if there is none
+    int pop();
+
+    /// Return a memory object to the pool of unused objects
+    void push(int ind);
+
+    /** \brief Append a new memory object, return its index
+
+        The caller must guarantee that add and clear are never called concurrently.
+    */
+    int add(void* mem);
+
+    /// Access a memory object
+    void* at(int ind) const;
+
+    /// Number of memory objects
+    int size() const { return size_.load(std::memory_order_acquire);}
+
+    /** \brief Remove all memory objects
+
+        Not thread-safe. The caller is responsible for freeing the memory objects.
+    */
+    void clear();
+
+  private:
+    // Memory object and link to the next unused object (index + 1, 0 for none)
+    struct Slot {
+      void* mem;
+      std::atomic<uint32_t> next;
+    };
+
+    // Chunk k holds 2^k slots
+    static const int n_chunk = 31;
+
+    // Locate a slot
+    Slot& slot(int ind) const;
+
+    // Slot storage
+    std::atomic<Slot*> chunk_[n_chunk];
+
+    // Number of memory objects
+    std::atomic<int> size_;
+
+    // Top of the stack of unused objects: ABA tag (upper half), index + 1 (lower half)
+    std::atomic<uint64_t> head_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_MEMORY_POOL_HPP
@@ -60,9 +60,19 @@ namespace casadi {
       {"live_variables",
        {OT_BOOL,
         "Reuse variables in the work vector"}},
+      {"work_allocation",
+       {OT_STRING,
+        "Allocation of live variables in the work vector: 'greedy' reuses variables "
+        "with identical number of nonzeros, 'interval' colors the live intervals "
+        "best-fit within size classes, preferring in-place operations "
+        "(Default: 'greedy')"}},
       {"print_instructions",
        {OT_BOOL,
         "Print each operation during evaluation"}},
+      {"profile_instructions",
+       {OT_BOOL,
+        "Accumulate number of calls and wall time per instruction during numerical "
+        "evaluation, see Function::print_profile and Function::save_profile (Default: false)"}},
       {"cse",
        {OT_BOOL,
         "Perform common subexpression elimination (complexity is N*log(N) in graph size)"}},
@@ -79,10 +89,57 @@ namespace casadi {
     Dict opts = FunctionInternal::generate_options(target);
     //opts["default_in"] = default_in_;
     opts["live_variables"] = live_variables_;
+    opts["work_allocation"] = work_allocation_;
     opts["print_instructions"] = print_instructions_;
+    opts["profile_instructions"] = profile_instructions_;
     return opts;
   }
 
+  Dict MXFunction::info() const {
+    return {{"work_allocation", live_variables_ ? work_allocation_ : "none"},
+            {"work_variables", static_cast<casadi_int>(workloc_.size()-1)},
+            {"work_allocated", workloc_.back()-workloc_.front()},
+            {"work_live_peak", work_live_peak()},
+            {"work_scratch", workloc_.front()}};
+  }
+
+  casadi_int MXFunction::work_live_peak() const {
+    casadi_int n_alg = algorithm_.size();
+    // Value currently held by each work vector element
+    std::vector<casadi_int> current(workloc_.size()-1, -1);
+    // Number of nonzeros, first and last instruction of each value
+    std::vector<casadi_int> nnz, first, last;
+    for (casadi_int k=0; k<n_alg; ++k) {
+      const AlgEl& e = algorithm_[k];
+      for (casadi_int a : e.arg) {
+        if (a>=0 && current[a]>=0) last[current[a]] = k;
+      }
+      for (casadi_int c=0; c<e.res.size(); ++c) {
+        casadi_int r = e.res[c];
+        if (r<0) continue;
+        // An argument overwritten in-place shares the memory of the result
+        casadi_int v = current[r];
+        if (v>=0 && last[v]==k && first[v]<k) last[v] = k-1;
+        current[r] = nnz.size();
+        nnz.push_back(e.data->sparsity(c).nnz());
+        first.push_back(k);
+        last.push_back(k);
+      }
+    }
+    // Sweep over the instructions
+    std::vector<casadi_int> delta(n_alg+1, 0);
+    for (casadi_int v=0; v<nnz.size(); ++v) {
+      delta[first[v]] += nnz[v];
+      delta[last[v]+1] -= nnz[v];
+    }
+    casadi_int live = 0, peak = 0;
+    for (casadi_int k=0; k<n_alg; ++k) {
+      live += delta[k];
+      peak = std::max(peak, live);
+    }
+    return peak;
+  }
+
   MX MXFunction::instruction_MX(casadi_int k) const {
     return algorithm_.at(k).data;
   }
@@ -114,6 +171,7 @@ namespace casadi {
 
     // Default (temporary) options
     live_variables_ = true;
+    work_allocation_ = "greedy";
     print_instructions_ = false;
     bool cse_opt = false;
     bool allow_free = false;
@@ -124,6 +182,11 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables_ = op.second;
+      } else if (op.first=="work_allocation") {
+        work_allocation_ = op.second.to_string();
+        casadi_assert(work_allocation_=="greedy" || work_allocation_=="interval",
+          "Option 'work_allocation' must be 'greedy' or 'interval', got '"
+          + work_allocation_ + "'");
       } else if (op.first=="print_instructions") {
         print_instructions_ = op.second;
       } else if (op.first=="cse") {
@@ -254,78 +317,172 @@ namespace casadi {
     std::vector<casadi_int>& place = place_in_alg; // Reuse memory as it is no longer needed
     place.resize(nodes.size());
 
-    // Stack with unused elements in the work vector, sorted by sparsity pattern
-    SPARSITY_MAP<casadi_int, std::stack<casadi_int> > unused_all;
-
     // Work vector size
     casadi_int worksize = 0;
 
-    // Find a place in the work vector for the operation
-    for (auto&& e : algorithm_) {
+    if (live_variables_ && work_allocation_=="interval") {
+      // Last instruction using each node
+      std::vector<casadi_int> last_use(nodes.size(), -1);
+      for (casadi_int k=0; k<algorithm_.size(); ++k) {
+        for (casadi_int a : algorithm_[k].arg) {
+          if (a>=0) last_use[a] = k;
+        }
+      }
 
-      // There are two tasks, allocate memory of the result and free the
-      // memory off the arguments, order depends on whether inplace is possible
-      casadi_int first_to_free = 0;
-      casadi_int last_to_free = e.data->n_inplace();
-      for (casadi_int task=0; task<2; ++task) {
+      // Size of each work vector element: largest number of nonzeros stored
+      std::vector<casadi_int> capacity;
+
+      // Free work vector elements by size class (empty, scalar, larger), sorted by capacity.
+      // Scalars and empty elements are code generated differently and never mixed with others.
+      std::vector<std::set<std::pair<casadi_int, casadi_int> > > free_work(3);
+      auto size_class = [](casadi_int nnz) -> casadi_int { return std::min(nnz, casadi_int(2));};
+
+      // Release the work vector element of a node
+      auto release = [&](casadi_int node) {
+        casadi_int w = place[node];
+        free_work[size_class(capacity[w])].insert(std::make_pair(capacity[w], w));
+      };
+
+      // Work vector elements of in-place arguments released at the current instruction
+      std::vector<casadi_int> inplace;
+
+      for (casadi_int k=0; k<algorithm_.size(); ++k) {
+        AlgEl& e = algorithm_[k];
+
+        // In-place arguments dying here can hold the results
+        inplace.clear();
+        casadi_int n_inplace = e.data->n_inplace();
+        for (casadi_int c=0; c<n_inplace; ++c) {
+          casadi_int a = e.arg[c];
+          if (a>=0 && last_use[a]==k
+              && std::find(e.arg.begin()+n_inplace, e.arg.end(), a)==e.arg.end()) {
+            last_use[a] = -1;  // Release once
+            release(a);
+            inplace.push_back(place[a]);
+          }
+        }
 
-        // Dereference or free the memory of the arguments
-        for (casadi_int c=last_to_free-1; c>=first_to_free; --c) { // reverse order so that the
-                                                          // first argument will end up
-                                                          // at the top of the stack
+        // Allocate the results
+        for (casadi_int c=0; c<e.res.size(); ++c) {
+          if (e.res[c]<0) continue;
+          casadi_int nnz = e.data->sparsity(c).nnz();
+          std::set<std::pair<casadi_int, casadi_int> >& fw = free_work[size_class(nnz)];
+          casadi_int w = -1;
+          // Prefer an in-place argument of the same size class
+          for (casadi_int i : inplace) {
+            if (size_class(capacity[i])==size_class(nnz) && fw.count(std::make_pair(capacity[i], i))) {
+              w = i;
+              break;
+            }
+          }
+          if (w<0) {
+            // Best fit, without wasting more than half of the element
+            auto it = fw.lower_bound(std::make_pair(nnz, casadi_int(-1)));
+            if (it!=fw.end() && it->first<=2*nnz) {
+              w = it->second;
+            } else if (it!=fw.begin()) {
+              // Grow the largest element that is too small
+              w = (--it)->second;
+            }
+          }
+          if (w>=0) {
+            fw.erase(std::make_pair(capacity[w], w));
+            capacity[w] = std::max(capacity[w], nnz);
+          } else {
+            // Allocate a new element in the work vector
+            w = worksize++;
+            capacity.push_back(nnz);
+          }
+          place[e.res[c]] = w;
+        }
 
-          // Index of the argument
-          casadi_int& ch_ind = e.arg[c];
-          if (ch_ind>=0) {
+        // Release the other arguments after their last use and results that are never used
+        for (casadi_int c=n_inplace; c<e.arg.size(); ++c) {
+          casadi_int a = e.arg[c];
+          if (a>=0 && last_use[a]==k) {
+            last_use[a] = -1;
+            release(a);
+          }
+        }
+        for (casadi_int c=0; c<e.res.size(); ++c) {
+          if (e.res[c]>=0 && last_use[e.res[c]]<0) release(e.res[c]);
+        }
+
+        // Point to places in the work vector instead of to places in the list of nodes
+        for (casadi_int& a : e.arg) if (a>=0) a = place[a];
+        for (casadi_int& r : e.res) if (r>=0) r = place[r];
+      }
+    } else {
+      // Stack with unused elements in the work vector, sorted by sparsity pattern
+      SPARSITY_MAP<casadi_int, std::stack<casadi_int> > unused_all;
 
-            // Decrease reference count and add to the stack of
-            // unused variables if the count hits zero
-            casadi_int remaining = --refcount[ch_ind];
+      // Find a place in the work vector for the operation
+      for (auto&& e : algorithm_) {
 
-            // Free variable for reuse
-            if (live_variables_ && remaining==0) {
+        // There are two tasks, allocate memory of the result and free the
+        // memory off the arguments, order depends on whether inplace is possible
+        casadi_int first_to_free = 0;
+        casadi_int last_to_free = e.data->n_inplace();
+        for (casadi_int task=0; task<2; ++task) {
 
-              // Get a pointer to the sparsity pattern of the argument that can be freed
-              casadi_int nnz = nodes[ch_ind]->sparsity().nnz();
+          // Dereference or free the memory of the arguments
+          for (casadi_int c=last_to_free-1; c>=first_to_free; --c) { // reverse order so that the
+                                                            // first argument will end up
+                                                            // at the top of the stack
 
-              // Add to the stack of unused work vector elements for the current sparsity
-              unused_all[nnz].push(place[ch_ind]);
-            }
+            // Index of the argument
+            casadi_int& ch_ind = e.arg[c];
+            if (ch_ind>=0) {
 
-            // Point to the place in the work vector instead of to the place in the list of nodes
-            ch_ind = place[ch_ind];
+              // Decrease reference count and add to the stack of
+              // unused variables if the count hits zero
+              casadi_int remaining = --refcount[ch_ind];
+
+              // Free variable for reuse
+              if (live_variables_ && remaining==0) {
+
+                // Get a pointer to the sparsity pattern of the argument that can be freed
+                casadi_int nnz = nodes[ch_ind]->sparsity().nnz();
+
+                // Add to the stack of unused work vector elements for the current sparsity
+                unused_all[nnz].push(place[ch_ind]);
+              }
+
+              // Point to the place in the work vector instead of to the place in the list of nodes
+              ch_ind = place[ch_ind];
+            }
           }
-        }
 
-        // Nothing more to allocate
-        if (task==1) break;
+          // Nothing more to allocate
+          if (task==1) break;
 
-        // Free the rest in the next iteration
-        first_to_free = last_to_free;
-        last_to_free = e.arg.size();
+          // Free the rest in the next iteration
+          first_to_free = last_to_free;
+          last_to_free = e.arg.size();
 
-        // Allocate/reuse memory for the results of the operation
-        for (casadi_int c=0; c<e.res.size(); ++c) {
-          if (e.res[c]>=0) {
+          // Allocate/reuse memory for the results of the operation
+          for (casadi_int c=0; c<e.res.size(); ++c) {
+            if (e.res[c]>=0) {
 
-            // Are reuse of variables (live variables) enabled?
-            if (live_variables_) {
-              // Get a pointer to the sparsity pattern node
-              casadi_int nnz = e.data->sparsity(c).nnz();
+              // Are reuse of variables (live variables) enabled?
+              if (live_variables_) {
+                // Get a pointer to the sparsity pattern node
+                casadi_int nnz = e.data->sparsity(c).nnz();
 
-              // Get a reference to the stack for the current sparsity
-              std::stack<casadi_int>& unused = unused_all[nnz];
+                // Get a reference to the stack for the current sparsity
+                std::stack<casadi_int>& unused = unused_all[nnz];
 
-              // Try to reuse a variable from the stack if possible (last in, first out)
-              if (!unused.empty()) {
-                e.res[c] = place[e.res[c]] = unused.top();
-                unused.pop();
-                continue; // Success, no new element needed in the work vector
+                // Try to reuse a variable from the stack if possible (last in, first out)
+                if (!unused.empty()) {
+                  e.res[c] = place[e.res[c]] = unused.top();
+                  unused.pop();
+                  continue; // Success, no new element needed in the work vector
+                }
               }
-            }
 
-            // Allocate a new element in the work vector
-            e.res[c] = place[e.res[c]] = worksize++;
+              // Allocate a new element in the work vector
+              e.res[c] = place[e.res[c]] = worksize++;
+            }
           }
         }
       }
@@ -340,10 +497,9 @@ namespace casadi {
       }
     }
 
-    // Allocate work vectors (numeric)
-    workloc_.resize(worksize+1);
-    std::fill(workloc_.begin(), workloc_.end(), -1);
-    size_t wind=0, sz_w=0;
+    // Size of each work vector element: largest number of nonzeros stored in it
+    std::vector<casadi_int> worknnz(worksize, 0);
+    size_t sz_w=0;
     for (auto&& e : algorithm_) {
       if (e.op!=OP_OUTPUT) {
         for (casadi_int c=0; c<e.res.size(); ++c) {
@@ -352,10 +508,22 @@ namespace casadi {
             alloc_res(e.data->sz_res());
             alloc_iw(e.data->sz_iw());
             sz_w = std::max(sz_w, e.data->sz_w());
-            if (workloc_[e.res[c]] < 0) {
-              workloc_[e.res[c]] = wind;
-              wind += e.data->sparsity(c).nnz();
-            }
+            worknnz[e.res[c]] = std::max(worknnz[e.res[c]], e.data->sparsity(c).nnz());
+          }
+        }
+      }
+    }
+
+    // Allocate work vectors (numeric)
+    workloc_.resize(worksize+1);
+    std::fill(workloc_.begin(), workloc_.end(), -1);
+    size_t wind=0;
+    for (auto&& e : algorithm_) {
+      if (e.op!=OP_OUTPUT) {
+        for (casadi_int c=0; c<e.res.size(); ++c) {
+          if (e.res[c]>=0 && workloc_[e.res[c]] < 0) {
+            workloc_[e.res[c]] = wind;
+            wind += worknnz[e.res[c]];
           }
         }
       }
@@ -447,9 +615,17 @@ namespace casadi {
     // Operation number (for printing)
     casadi_int k = 0;
 
+    // Per-instruction statistics
+    InstructionStats* prof = nullptr;
+    if (profile_instructions_) {
+      prof = &static_cast<XFunctionMemory*>(mem)->instr_stats;
+      if (prof->n_call.size()!=algorithm_.size()) prof->reset(algorithm_.size());
+    }
+
     // Evaluate all of the nodes of the algorithm:
     // should only evaluate nodes that have not yet been calculated!
     for (auto&& e : algorithm_) {
+      if (prof) prof->tic();
       // Perform the operation
       if (e.op==OP_INPUT) {
         // Pass an input
@@ -481,12 +657,23 @@ namespace casadi {
         if (e.data->eval(arg1, res1, iw, w)) return 1;
         if (print_instructions_) print_res(uout(), k, e, res1);
       }
+      if (prof) prof->toc(k);
       // Increase counter
       k++;
     }
     return 0;
   }
 
+  void MXFunction::instruction_labels(std::vector<std::string>& type,
+      std::vector<std::string>& descr) const {
+    type.clear();
+    descr.clear();
+    for (auto&& e : algorithm_) {
+      type.push_back(casadi_math<double>::name(e.op));
+      descr.push_back(print(e));
+    }
+  }
+
   std::string MXFunction::print(const AlgEl& el) const {
     std::stringstream s;
     if (el.op==OP_OUTPUT) {
@@ -1802,7 +1989,7 @@ namespace casadi {
   void MXFunction::serialize_body(SerializingStream &s) const {
     XFunction<MXFunction, MX, MXNode>::serialize_body(s);
 
-    s.version("MXFunction", 2);
+    s.version("MXFunction", 4);
     s.pack("MXFunction::n_instr", algorithm_.size());
 
     // Loop over algorithm
@@ -1817,13 +2004,15 @@ namespace casadi {
     s.pack("MXFunction::default_in", default_in_);
     s.pack("MXFunction::live_variables", live_variables_);
     s.pack("MXFunction::print_instructions", print_instructions_);
+    s.pack("MXFunction::work_allocation", work_allocation_);
+    s.pack("MXFunction::profile_instructions", profile_instructions_);
 
     XFunction<MXFunction, MX, MXNode>::delayed_serialize_members(s);
   }
 
 
   MXFunction::MXFunction(DeserializingStream& s) : XFunction<MXFunction, MX, MXNode>(s) {
-    int version = s.version("MXFunction", 1, 2);
+    int version = s.version("MXFunction", 1, 4);
     size_t n_instructions;
     s.unpack("MXFunction::n_instr", n_instructions);
     algorithm_.resize(n_instructions);
@@ -1841,6 +2030,9 @@ namespace casadi {
     s.unpack("MXFunction::live_variables", live_variables_);
     print_instructions_ = false;
     if (version >= 2) s.unpack("MXFunction::print_instructions", print_instructions_);
+    work_allocation_ = "greedy";
+    if (version >= 3) s.unpack("MXFunction::work_allocation", work_allocation_);
+    if (version >= 4) s.unpack("MXFunction::profile_instructions", profile_instructions_);
 
     XFunction<MXFunction, MX, MXNode>::delayed_deserialize_members(s);
   }
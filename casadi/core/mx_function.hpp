@@ -96,6 +96,9 @@ namespace casadi {
     /// Print instructions during evaluation
     bool print_instructions_;
 
+    /// Allocation scheme for live variables: "greedy" or "interval"
+    std::string work_allocation_;
+
     /** \brief Constructor
 
         \identifier{22} */
@@ -143,6 +146,15 @@ namespace casadi {
     /// Reconstruct options dict
     Dict generate_options(const std::string& target="clone") const override;
 
+    /** \brief Obtain information about the function
+
+        Reports the peak number of live work vector nonzeros next to the
+        number actually allocated */
+    Dict info() const override;
+
+    /// Largest number of work vector nonzeros live at any instruction
+    casadi_int work_live_peak() const;
+
     /** \brief  Initialize
 
         \identifier{29} */
@@ -238,6 +250,10 @@ namespace casadi {
     // Print the output arguments of an instruction
     void print_res(std::ostream &stream, casadi_int k, const AlgEl& el, double** res) const;
 
+    // Instruction types and descriptions for the instruction profile
+    void instruction_labels(std::vector<std::string>& type,
+                            std::vector<std::string>& descr) const;
+
     ///@{
     /** \brief Get function input(s) and output(s)
 
@@ -0,0 +1,315 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "native_jit.hpp"
+#include "sx_function.hpp"
+#include "calculus.hpp"
+
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) && defined(__linux__)
+#define CASADI_NATIVE_JIT
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // defined(__x86_64__) && defined(__linux__)
+
+namespace casadi {
+
+  // General purpose registers
+  enum {JIT_RAX=0, JIT_RBX=3, JIT_R12=12, JIT_R13=13, JIT_R14=14};
+
+  // Registers holding the arguments of the generated function (callee-saved)
+  enum {JIT_ARG=JIT_RBX, JIT_RES=JIT_R12, JIT_W=JIT_R13, JIT_POOL=JIT_R14};
+
+  // Positions in the constant pool
+  enum {JIT_ONE, JIT_SIGN, JIT_MAGNITUDE, JIT_NUM_POOL};
+
+  // Scalar double precision SSE2 instructions
+  enum {SSE_MOVSD_LOAD=0x10, SSE_MOVSD_STORE=0x11, SSE_SQRT=0x51, SSE_AND=0x54, SSE_OR=0x56,
+        SSE_XOR=0x57, SSE_ADD=0x58, SSE_MUL=0x59, SSE_SUB=0x5C, SSE_DIV=0x5E, SSE_CMP=0xC2};
+
+  // Predicates for SSE_CMP
+  enum {CMP_EQ=0, CMP_LT=1, CMP_LE=2, CMP_NE=4};
+
+  // Numerical implementation of an operation, called from the generated code
+  template<casadi_int I>
+  double native_jit_fcn(double x, double y) {
+    double f;
+    BinaryOperation<I>::fcn(x, y, f);
+    return f;
+  }
+
+  NativeJit::NativeJit() : exec_(nullptr), exec_size_(0), fcn_(nullptr) {
+  }
+
+  NativeJit::~NativeJit() {
+    clear();
+  }
+
+  bool NativeJit::is_supported() {
+#ifdef CASADI_NATIVE_JIT
+    return true;
+#else // CASADI_NATIVE_JIT
+    return false;
+#endif // CASADI_NATIVE_JIT
+  }
+
+  void NativeJit::clear() {
+#ifdef CASADI_NATIVE_JIT
+    if (exec_) munmap(exec_, exec_size_);
+#endif // CASADI_NATIVE_JIT
+    exec_ = nullptr;
+    exec_size_ = 0;
+    fcn_ = nullptr;
+    code_.clear();
+    pool_.clear();
+    error_.clear();
+  }
+
+  bool NativeJit::fail(const std::string& msg) {
+    clear();
+    error_ = msg;
+    return false;
+  }
+
+  void NativeJit::emit32(int32_t v) {
+    for (casadi_int i=0; i<4; ++i) emit(static_cast<unsigned char>(v >> (8*i)));
+  }
+
+  void NativeJit::emit64(uint64_t v) {
+    for (casadi_int i=0; i<8; ++i) emit(static_cast<unsigned char>(v >> (8*i)));
+  }
+
+  void NativeJit::rex(bool w, int reg, int base) {
+    unsigned char r = 0x40 | (w ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | ((base & 8) ? 0x01 : 0);
+    if (r!=0x40) emit(r);
+  }
+
+  void NativeJit::modrm(int reg, int base, int32_t disp) {
+    // Always [base + disp32]; rsp/r12 as base require a SIB byte
+    emit(0x80 | ((reg & 7) << 3) | (base & 7));
+    if ((base & 7)==4) emit(0x24);
+    emit32(disp);
+  }
+
+  void NativeJit::sse(unsigned char prefix, unsigned char opc, int xmm, int base, int32_t disp) {
+    emit(prefix);
+    rex(false, xmm, base);
+    emit(0x0F);
+    emit(opc);
+    modrm(xmm, base, disp);
+  }
+
+  void NativeJit::sse_rr(unsigned char prefix, unsigned char opc, int dst, int src) {
+    emit(prefix);
+    emit(0x0F);
+    emit(opc);
+    emit(0xC0 | (dst << 3) | src);
+  }
+
+  void NativeJit::load(int xmm, int base, casadi_int k) {
+    sse(0xF2, SSE_MOVSD_LOAD, xmm, base, static_cast<int32_t>(8*k));
+  }
+
+  void NativeJit::store(int base, casadi_int k, int xmm) {
+    sse(0xF2, SSE_MOVSD_STORE, xmm, base, static_cast<int32_t>(8*k));
+  }
+
+  bool NativeJit::compile(const std::vector<ScalarAtomic>& algorithm) {
+    clear();
+#ifdef CASADI_NATIVE_JIT
+    // Displacements are encoded as 32-bit integers
+    const casadi_int max_ind = std::numeric_limits<int32_t>::max()/8 - JIT_NUM_POOL;
+
+    // Constant pool
+    pool_.resize(JIT_NUM_POOL);
+    pool_[JIT_ONE] = 1;
+    uint64_t mask = uint64_t(1) << 63;
+    std::memcpy(&pool_[JIT_SIGN], &mask, sizeof(double));
+    mask = ~mask;
+    std::memcpy(&pool_[JIT_MAGNITUDE], &mask, sizeof(double));
+
+    // Prologue: save callee-saved registers (five pushes keep the stack 16-byte aligned)
+    emit(0x53);               // push rbx
+    emit(0x41); emit(0x54);   // push r12
+    emit(0x41); emit(0x55);   // push r13
+    emit(0x41); emit(0x56);   // push r14
+    emit(0x41); emit(0x57);   // push r15
+    emit(0x48); emit(0x89); emit(0xFB);  // mov rbx, rdi
+    emit(0x49); emit(0x89); emit(0xF4);  // mov r12, rsi
+    emit(0x49); emit(0x89); emit(0xD5);  // mov r13, rdx
+    emit(0x49); emit(0x89); emit(0xCE);  // mov r14, rcx
+
+    for (auto&& e : algorithm) {
+      // Constants only have a result index, i1 and i2 overlap with the value
+      if (e.i0<0 || e.i0>max_ind || (e.op!=OP_CONST
+          && (e.i1<0 || e.i1>max_ind || e.i2<0 || e.i2>max_ind))) {
+        return fail("work vector index out of range in '"
+                    + casadi_math<double>::name(e.op) + "'");
+      }
+      switch (e.op) {
+      case OP_CONST:
+        load(0, JIT_POOL, pool_.size());
+        pool_.push_back(e.d);
+        if (pool_.size()>max_ind) return fail("too many constants");
+        break;
+      case OP_INPUT:
+        {
+          // mov rax, [arg + 8*i1]; test rax, rax; jz zero
+          rex(true, JIT_RAX, JIT_ARG); emit(0x8B); modrm(JIT_RAX, JIT_ARG, 8*e.i1);
+          emit(0x48); emit(0x85); emit(0xC0);
+          emit(0x74); emit(0);
+          size_t jz = code_.size();
+          // movsd xmm0, [rax + 8*i2]; jmp done
+          load(0, JIT_RAX, e.i2);
+          emit(0xEB); emit(0);
+          size_t jmp = code_.size();
+          code_[jz-1] = static_cast<unsigned char>(jmp - jz);
+          // zero: xorpd xmm0, xmm0
+          sse_rr(0x66, SSE_XOR, 0, 0);
+          code_[jmp-1] = static_cast<unsigned char>(code_.size() - jmp);
+        }
+        break;
+      case OP_OUTPUT:
+        {
+          // mov rax, [res + 8*i0]; test rax, rax; jz done
+          rex(true, JIT_RAX, JIT_RES); emit(0x8B); modrm(JIT_RAX, JIT_RES, 8*e.i0);
+          emit(0x48); emit(0x85); emit(0xC0);
+          emit(0x74); emit(0);
+          size_t jz = code_.size();
+          // movsd xmm0, [w + 8*i1]; movsd [rax + 8*i2], xmm0
+          load(0, JIT_W, e.i1);
+          store(JIT_RAX, e.i2, 0);
+          code_[jz-1] = static_cast<unsigned char>(code_.size() - jz);
+        }
+        continue;
+      case OP_ASSIGN:
+        load(0, JIT_W, e.i1);
+        break;
+      case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV:
+        load(0, JIT_W, e.i1);
+        sse(0xF2, e.op==OP_ADD ? SSE_ADD : e.op==OP_SUB ? SSE_SUB : e.op==OP_MUL ? SSE_MUL
+            : SSE_DIV, 0, JIT_W, 8*e.i2);
+        break;
+      case OP_SQ:
+        load(0, JIT_W, e.i1);
+        sse_rr(0xF2, SSE_MUL, 0, 0);
+        break;
+      case OP_TWICE:
+        load(0, JIT_W, e.i1);
+        sse_rr(0xF2, SSE_ADD, 0, 0);
+        break;
+      case OP_INV:
+        load(0, JIT_POOL, JIT_ONE);
+        sse(0xF2, SSE_DIV, 0, JIT_W, 8*e.i1);
+        break;
+      case OP_SQRT:
+        sse(0xF2, SSE_SQRT, 0, JIT_W, 8*e.i1);
+        break;
+      case OP_NEG: case OP_FABS:
+        load(0, JIT_W, e.i1);
+        load(1, JIT_POOL, e.op==OP_NEG ? JIT_SIGN : JIT_MAGNITUDE);
+        sse_rr(0x66, e.op==OP_NEG ? SSE_XOR : SSE_AND, 0, 1);
+        break;
+      case OP_LT: case OP_LE: case OP_EQ: case OP_NE:
+        // All-ones mask if true, masked with 1.0
+        load(0, JIT_W, e.i1);
+        sse(0xF2, SSE_CMP, 0, JIT_W, 8*e.i2);
+        emit(e.op==OP_LT ? CMP_LT : e.op==OP_LE ? CMP_LE : e.op==OP_EQ ? CMP_EQ : CMP_NE);
+        load(1, JIT_POOL, JIT_ONE);
+        sse_rr(0x66, SSE_AND, 0, 1);
+        break;
+      case OP_NOT:
+        load(0, JIT_W, e.i1);
+        sse_rr(0x66, SSE_XOR, 1, 1);
+        sse_rr(0xF2, SSE_CMP, 0, 1); emit(CMP_EQ);
+        load(1, JIT_POOL, JIT_ONE);
+        sse_rr(0x66, SSE_AND, 0, 1);
+        break;
+      case OP_AND: case OP_OR: case OP_IF_ELSE_ZERO:
+        // Nonzero masks (true also for NaN, as in C++)
+        sse_rr(0x66, SSE_XOR, 2, 2);
+        load(0, JIT_W, e.i1);
+        sse_rr(0xF2, SSE_CMP, 0, 2); emit(CMP_NE);
+        load(1, JIT_W, e.i2);
+        if (e.op==OP_IF_ELSE_ZERO) {
+          sse_rr(0x66, SSE_AND, 0, 1);
+        } else {
+          sse_rr(0xF2, SSE_CMP, 1, 2); emit(CMP_NE);
+          sse_rr(0x66, e.op==OP_AND ? SSE_AND : SSE_OR, 0, 1);
+          load(1, JIT_POOL, JIT_ONE);
+          sse_rr(0x66, SSE_AND, 0, 1);
+        }
+        break;
+      default:
+        {
+          // Call numerical implementation: f = fcn(x, y) with x, y and f in xmm0, xmm1 and xmm0
+          double (*fcn)(double, double) = nullptr;
+          switch (e.op) {
+#define CASADI_NATIVE_JIT_CASE(OP) case OP: fcn = native_jit_fcn<OP>; break;
+            CASADI_SX_BYTECODE_BUILTIN(CASADI_NATIVE_JIT_CASE)
+#undef CASADI_NATIVE_JIT_CASE
+          default:
+            // Call nodes, parameters, ...
+            return fail("operation '" + casadi_math<double>::name(e.op) + "' is not supported");
+          }
+          load(0, JIT_W, e.i1);
+          load(1, JIT_W, e.i2);
+          emit(0x48); emit(0xB8); emit64(reinterpret_cast<uint64_t>(fcn));  // mov rax, fcn
+          emit(0xFF); emit(0xD0);  // call rax
+        }
+      }
+      // Store result: movsd [w + 8*i0], xmm0
+      store(JIT_W, e.i0, 0);
+    }
+
+    // Epilogue
+    emit(0x41); emit(0x5F);   // pop r15
+    emit(0x41); emit(0x5E);   // pop r14
+    emit(0x41); emit(0x5D);   // pop r13
+    emit(0x41); emit(0x5C);   // pop r12
+    emit(0x5B);               // pop rbx
+    emit(0xC3);               // ret
+
+    // Copy to memory that is first writable, then executable
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    exec_size_ = ((code_.size() + page - 1) / page) * page;
+    void* p = mmap(nullptr, exec_size_, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p==MAP_FAILED) return fail("could not allocate memory for the machine code");
+    exec_ = p;
+    std::memcpy(exec_, code_.data(), code_.size());
+    if (mprotect(exec_, exec_size_, PROT_READ | PROT_EXEC)) {
+      return fail("could not make the machine code executable");
+    }
+    fcn_ = reinterpret_cast<Fcn>(exec_);
+    return true;
+#else // CASADI_NATIVE_JIT
+    return fail("not supported on this platform");
+#endif // CASADI_NATIVE_JIT
+  }
+
+} // namespace casadi
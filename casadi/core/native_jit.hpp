@@ -0,0 +1,129 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_NATIVE_JIT_HPP
+#define CASADI_NATIVE_JIT_HPP
+
+#include "casadi_common.hpp"
+
+#include <string>
+#include <vector>
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  // Forward declaration
+  struct ScalarAtomic;
+
+  /** \brief In-process machine code generation for an SX algorithm
+
+      Translates the scalar algorithm of an SXFunction into x86-64 (System V ABI, SSE2)
+      machine code in executable memory, without invoking an external compiler.
+      Arithmetic, comparison and logical operations are emitted inline, all other
+      operations as calls to the numerical implementation in casadi_math.
+  */
+  class CASADI_EXPORT NativeJit {
+  public:
+    /// Signature of the generated code
+    typedef void (*Fcn)(const double** arg, double** res, double* w, const double* pool);
+
+    /// Constructor
+    NativeJit();
+
+    /// Destructor, releases the executable memory
+    ~NativeJit();
+
+    /// Is native code generation available on this platform?
+    static bool is_supported();
+
+    /** \brief Generate code for an algorithm
+
+        Returns false, leaving the instance empty, if the algorithm contains
+        operations that cannot be translated (e.g. call nodes or free variables).
+        The reason is then available from error().
+    */
+    bool compile(const std::vector<ScalarAtomic>& algorithm);
+
+    /// Reason why the last call to compile failed
+    const std::string& error() const { return error_;}
+
+    /// Has code been generated?
+    bool is_compiled() const { return fcn_!=nullptr;}
+
+    /// Size of the generated code in bytes
+    size_t code_size() const { return code_.size();}
+
+    /// Evaluate
+    void eval(const double** arg, double** res, double* w) const {
+      fcn_(arg, res, w, pool_.data());
+    }
+
+  private:
+    // Not copyable
+    NativeJit(const NativeJit&);
+    NativeJit& operator=(const NativeJit&);
+
+    /// Release executable memory
+    void clear();
+
+    /// Release executable memory, record the reason and return false
+    bool fail(const std::string& msg);
+
+    ///@{
+    /// Instruction encoding
+    void emit(unsigned char b) { code_.push_back(b);}
+    void emit32(int32_t v);
+    void emit64(uint64_t v);
+    void rex(bool w, int reg, int base);
+    void modrm(int reg, int base, int32_t disp);
+    void sse(unsigned char prefix, unsigned char opc, int xmm, int base, int32_t disp);
+    void sse_rr(unsigned char prefix, unsigned char opc, int dst, int src);
+    void load(int xmm, int base, casadi_int k);
+    void store(int base, casadi_int k, int xmm);
+    ///@}
+
+    /// Machine code
+    std::vector<unsigned char> code_;
+
+    /// Constant pool: 1.0, sign mask, magnitude mask, followed by the constants
+    std::vector<double> pool_;
+
+    /// Executable memory
+    void* exec_;
+    size_t exec_size_;
+
+    /// Entry point
+    Fcn fcn_;
+
+    /// Reason of the last failure
+    std::string error_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_NATIVE_JIT_HPP
@@ -62,6 +62,12 @@ const Options OracleFunction::options_
     {"show_eval_warnings",
       {OT_BOOL,
       "Show warnings generated from function evaluations [true]"}},
+    {"cache_evaluations",
+      {OT_BOOL,
+      "Keep the outputs of the last evaluation at each point and reuse them when a "
+      "problem function is called again with identical inputs. Outputs are shared between "
+      "functions with the same input names, e.g. f and g from nlp_jac_fg are reused by "
+      "nlp_fg. Hits and misses are reported in the statistics [false]"}},
     {"common_options",
       {OT_DICT,
       "Options for auto-generated functions"}},
@@ -81,6 +87,7 @@ void OracleFunction::init(const Dict& opts) {
   bool postpone_expand = false;
 
   show_eval_warnings_ = true;
+  cache_evaluations_ = false;
 
   max_num_threads_ = 1;
   post_expand_ = false;
@@ -105,6 +112,8 @@ void OracleFunction::init(const Dict& opts) {
       monitor_ = op.second;
     } else if (op.first=="show_eval_warnings") {
       show_eval_warnings_ = op.second;
+    } else if (op.first=="cache_evaluations") {
+      cache_evaluations_ = op.second;
     }
   }
 
@@ -289,6 +298,8 @@ set_function(const Function& fcn, const std::string& fname, bool jit) {
   RegFun& r = all_functions_[fname];
   r.f = fcn;
   r.jit = jit;
+  r.cache_in = join(fcn.name_in());
+  r.cache_out = fcn.name_out();
 }
 
 
@@ -324,15 +335,17 @@ calc_function(OracleMemory* m, const std::string& fcn,
   // Number of inputs and outputs
   casadi_int n_in = f.n_in(), n_out = f.n_out();
 
-  // Prepare stats, start timer
-  ScopedTiming tic(fstats);
-
   // Input buffers
   if (arg) {
     std::fill_n(ml->arg, n_in, nullptr);
     for (casadi_int i=0; i<n_in; ++i) ml->arg[i] = *arg++;
   }
 
+  // Outputs from an earlier evaluation at the same point, if any
+  const RegFun* r = cache_evaluations_ ? &all_functions_.at(fcn) : nullptr;
+  bool cache_hit = r && cache_lookup(ml, *r);
+  if (monitored && cache_hit) casadi_message("Reusing cached outputs of \"" + fcn + "\"");
+
   // Print inputs nonzeros
   if (monitored) {
     std::stringstream s;
@@ -357,10 +370,14 @@ calc_function(OracleMemory* m, const std::string& fcn,
 
   // Evaluate memory-less
   try {
-    if (f(ml->arg, ml->res, ml->iw, ml->w)) {
-      // Recoverable error
-      if (monitored) casadi_message(name_ + ":" + fcn + " failed");
-      return 1;
+    if (!cache_hit) {
+      // Prepare stats, start timer
+      ScopedTiming tic(fstats);
+      if (r ? cache_eval(ml, *r) : f(ml->arg, ml->res, ml->iw, ml->w)) {
+        // Recoverable error
+        if (monitored) casadi_message(name_ + ":" + fcn + " failed");
+        return 1;
+      }
     }
   } catch(std::exception& ex) {
     // Fatal error: Generate stack trace
@@ -415,6 +432,82 @@ calc_function(OracleMemory* m, const std::string& fcn,
   return 0;
 }
 
+bool OracleFunction::cache_lookup(LocalOracleMemory* ml, const RegFun& r) const {
+  const Function& f = r.f;
+  auto it = ml->cache.find(r.cache_in);
+  if (it == ml->cache.end()) return false;
+  const OracleCacheEntry& e = it->second;
+  // Compare inputs
+  if (static_cast<casadi_int>(e.in.size()) != f.nnz_in()) return false;
+  const double* in = get_ptr(e.in);
+  for (casadi_int i=0; i<f.n_in(); ++i) {
+    casadi_int nnz = f.nnz_in(i);
+    if (ml->arg[i]) {
+      if (!std::equal(ml->arg[i], ml->arg[i] + nnz, in)) return false;
+    } else {
+      if (!std::all_of(in, in + nnz, [](double v) { return v==0;})) return false;
+    }
+    in += nnz;
+  }
+  // All requested outputs available?
+  for (casadi_int i=0; i<f.n_out(); ++i) {
+    if (!ml->res[i]) continue;
+    auto it_out = e.out.find(r.cache_out[i]);
+    if (it_out == e.out.end() || static_cast<casadi_int>(it_out->second.size()) != f.nnz_out(i)) {
+      return false;
+    }
+  }
+  // Copy outputs
+  for (casadi_int i=0; i<f.n_out(); ++i) {
+    if (ml->res[i]) casadi_copy(get_ptr(e.out.at(r.cache_out[i])), f.nnz_out(i), ml->res[i]);
+  }
+  ml->cache_hits++;
+  return true;
+}
+
+int OracleFunction::cache_eval(LocalOracleMemory* ml, const RegFun& r) const {
+  const Function& f = r.f;
+  casadi_int n_in = f.n_in(), n_out = f.n_out();
+  ml->cache_misses++;
+  // Gather inputs, discarding outputs at a different point
+  OracleCacheEntry& e = ml->cache[r.cache_in];
+  std::vector<double> in(f.nnz_in());
+  double* in_ptr = get_ptr(in);
+  for (casadi_int i=0; i<n_in; ++i) {
+    casadi_copy(ml->arg[i], f.nnz_in(i), in_ptr);
+    in_ptr += f.nnz_in(i);
+  }
+  if (in != e.in) {
+    e.in.swap(in);
+    e.out.clear();
+  }
+  // Evaluate all outputs into the cache
+  ml->cache_res.assign(ml->res, ml->res + n_out);
+  for (casadi_int i=0; i<n_out; ++i) {
+    std::vector<double>& out = e.out[r.cache_out[i]];
+    out.resize(f.nnz_out(i));
+    ml->res[i] = get_ptr(out);
+  }
+  int flag;
+  try {
+    flag = f(ml->arg, ml->res, ml->iw, ml->w);
+  } catch (...) {
+    std::copy(ml->cache_res.begin(), ml->cache_res.end(), ml->res);
+    ml->cache.erase(r.cache_in);
+    throw;
+  }
+  std::copy(ml->cache_res.begin(), ml->cache_res.end(), ml->res);
+  if (flag) {
+    ml->cache.erase(r.cache_in);
+    return flag;
+  }
+  // Pass requested outputs to the caller
+  for (casadi_int i=0; i<n_out; ++i) {
+    if (ml->res[i]) casadi_copy(get_ptr(e.out.at(r.cache_out[i])), f.nnz_out(i), ml->res[i]);
+  }
+  return 0;
+}
+
 int OracleFunction::calc_sp_forward(const std::string& fcn, const bvec_t** arg, bvec_t** res,
     casadi_int* iw, bvec_t* w) const {
   return get_function(fcn)(arg, res, iw, w);
@@ -458,7 +551,16 @@ void OracleFunction::expand() {
 
 Dict OracleFunction::get_stats(void *mem) const {
   Dict stats = FunctionInternal::get_stats(mem);
-  //auto m = static_cast<OracleMemory*>(mem);
+  auto m = static_cast<OracleMemory*>(mem);
+  if (cache_evaluations_) {
+    casadi_int hits = 0, misses = 0;
+    for (auto* ml : m->thread_local_mem) {
+      hits += ml->cache_hits;
+      misses += ml->cache_misses;
+    }
+    stats["cache_hits"] = hits;
+    stats["cache_misses"] = misses;
+  }
   return stats;
 }
 
@@ -471,6 +573,7 @@ int OracleFunction::local_init_mem(void* mem) const {
   for (auto&& e : all_functions_) {
     m->add_stat(e.first);
   }
+  m->cache_hits = m->cache_misses = 0;
 
   return 0;
 }
@@ -517,6 +620,7 @@ void OracleFunction::set_temp(void* mem, const double** arg, double** res,
   for (int i = 0; i < max_num_threads_; ++i) {
     auto* ml = m->thread_local_mem[i];
     for (auto&& s : ml->fstats) s.second.reset();
+    ml->cache_hits = ml->cache_misses = 0;
     ml->arg = arg;
     ml->res = res;
     ml->iw = iw;
@@ -561,12 +665,13 @@ bool OracleFunction::has_function(const std::string& fname) const {
 void OracleFunction::serialize_body(SerializingStream &s) const {
   FunctionInternal::serialize_body(s);
 
-  s.version("OracleFunction", 3);
+  s.version("OracleFunction", 4);
   s.pack("OracleFunction::oracle", oracle_);
   s.pack("OracleFunction::common_options", common_options_);
   s.pack("OracleFunction::specific_options", specific_options_);
   s.pack("OracleFunction::show_eval_warnings", show_eval_warnings_);
   s.pack("OracleFunction::max_num_threads", max_num_threads_);
+  s.pack("OracleFunction::cache_evaluations", cache_evaluations_);
   s.pack("OracleFunction::all_functions::size", all_functions_.size());
   for (auto &e : all_functions_) {
     s.pack("OracleFunction::all_functions::key", e.first);
@@ -585,6 +690,8 @@ void OracleFunction::serialize_body(SerializingStream &s) const {
       s.pack("OracleFunction::all_functions::value::f", e.second.f);
     }
     s.pack("OracleFunction::all_functions::value::monitored", e.second.monitored);
+    s.pack("OracleFunction::all_functions::value::cache_in", e.second.cache_in);
+    s.pack("OracleFunction::all_functions::value::cache_out", e.second.cache_out);
   }
   s.pack("OracleFunction::monitor", monitor_);
   s.pack("OracleFunction::stride_arg", stride_arg_);
@@ -596,7 +703,7 @@ void OracleFunction::serialize_body(SerializingStream &s) const {
 
 OracleFunction::OracleFunction(DeserializingStream& s) : FunctionInternal(s) {
 
-  int version = s.version("OracleFunction", 1, 3);
+  int version = s.version("OracleFunction", 1, 4);
   s.unpack("OracleFunction::oracle", oracle_);
   s.unpack("OracleFunction::common_options", common_options_);
   s.unpack("OracleFunction::specific_options", specific_options_);
@@ -607,6 +714,11 @@ OracleFunction::OracleFunction(DeserializingStream& s) : FunctionInternal(s) {
   } else {
     max_num_threads_ = 1;
   }
+  if (version>=4) {
+    s.unpack("OracleFunction::cache_evaluations", cache_evaluations_);
+  } else {
+    cache_evaluations_ = false;
+  }
 
   size_t size;
 
@@ -634,6 +746,10 @@ OracleFunction::OracleFunction(DeserializingStream& s) : FunctionInternal(s) {
       }
     }
     s.unpack("OracleFunction::all_functions::value::monitored", r.monitored);
+    if (version>=4) {
+      s.unpack("OracleFunction::all_functions::value::cache_in", r.cache_in);
+      s.unpack("OracleFunction::all_functions::value::cache_out", r.cache_out);
+    }
     all_functions_[key] = r;
   }
   s.unpack("OracleFunction::monitor", monitor_);
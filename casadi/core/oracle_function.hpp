@@ -44,6 +44,14 @@ namespace casadi {
   template<typename T1>
   int calc_function(const OracleCallback* cb, casadi_oracle_data<T1>* d);
 
+  /** \brief Oracle outputs at the last point evaluated, for one set of input names */
+  struct CASADI_EXPORT OracleCacheEntry {
+    // Input nonzeros, zero for null inputs
+    std::vector<double> in;
+    // Output nonzeros, by output name
+    std::map<std::string, std::vector<double>> out;
+  };
+
   /** \brief Function memory with temporary work vectors
 
       \identifier{b} */
@@ -53,6 +61,13 @@ namespace casadi {
     double** res;
     casadi_int* iw;
     double* w;
+
+    // Cached oracle outputs, by input names
+    std::map<std::string, OracleCacheEntry> cache;
+    // Output buffers of the caller during a cached evaluation
+    std::vector<double*> cache_res;
+    // Evaluations avoided and performed with the cache enabled
+    casadi_int cache_hits, cache_misses;
   };
 
   /** \brief Function memory
@@ -92,12 +107,18 @@ namespace casadi {
     // Maximum number of threads
     int max_num_threads_;
 
+    // Reuse outputs for identical inputs?
+    bool cache_evaluations_;
+
     // Information about one function
     struct RegFun {
       Function f;
       bool jit;
       Function f_original; // Relevant for jit
       bool monitored = false;
+      // Input names, identifying the cache entry, and output names
+      std::string cache_in;
+      std::vector<std::string> cache_out;
     };
 
     // All NLP functions
@@ -186,6 +207,12 @@ namespace casadi {
     int calc_function(OracleMemory* m, const std::string& fcn,
       const double* const* arg=nullptr, int thread_id=0) const;
 
+    // Get the outputs of a function from the cache, if all requested outputs are there
+    bool cache_lookup(LocalOracleMemory* ml, const RegFun& r) const;
+
+    // Evaluate a function, storing all outputs in the cache
+    int cache_eval(LocalOracleMemory* ml, const RegFun& r) const;
+
     // Forward sparsity propagation through a function
     int calc_sp_forward(const std::string& fcn, const bvec_t** arg, bvec_t** res,
       casadi_int* iw, bvec_t* w) const;
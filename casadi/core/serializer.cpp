@@ -31,7 +31,15 @@
 #include "importer.hpp"
 #include "generic_type.hpp"
 #include "filesystem_impl.hpp"
+#include "mapped_file.hpp"
+#include "casadi_os.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
 #include <iomanip>
+#include <random>
+#include <thread>
 
 namespace casadi {
 
@@ -39,11 +47,33 @@ namespace casadi {
         SerializerBase(std::unique_ptr<std::ostream>(new std::stringstream()), opts) {
     }
 
+    /// Name of a temporary file next to fname, unique across threads and processes
+    static std::string temporary_sibling(const std::string& fname) {
+      static std::atomic<unsigned> counter(0);
+      std::default_random_engine rng(static_cast<unsigned>(
+        std::chrono::high_resolution_clock::now().time_since_epoch().count())
+        ^ static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id()))
+        ^ counter++);
+      std::string chars = "abcdefghijklmnopqrstuvwxyz0123456789";
+      std::uniform_int_distribution<> r(0, static_cast<int>(chars.size())-1);
+      std::string ret = fname + ".tmp";
+      for (casadi_int i=0; i<8; ++i) ret += chars.at(r(rng));
+      return ret;
+    }
+
     FileSerializer::FileSerializer(const std::string& fname, const Dict& opts) :
+        FileSerializer(fname, temporary_sibling(fname), opts) {
+    }
+
+    FileSerializer::FileSerializer(const std::string& fname, const std::string& tmp_name,
+        const Dict& opts) try :
         SerializerBase(
           std::unique_ptr<std::ostream>(
-            Filesystem::ofstream_ptr(fname, std::ios_base::binary | std::ios::out)),
-          opts) {
+            Filesystem::ofstream_ptr(tmp_name, std::ios_base::binary | std::ios::out)),
+          opts), fname_(fname), tmp_name_(tmp_name) {
+    } catch (...) {
+      // Do not leave the temporary file behind, e.g. for unknown options
+      std::remove(tmp_name.c_str());
     }
 
     SerializerBase::SerializerBase(std::unique_ptr<std::ostream> stream, const Dict& opts) :
@@ -81,17 +111,52 @@ namespace casadi {
       }
     }
 
+    void FileSerializer::finalize() {
+      if (!serializer_) return;
+      // Flush pending data and close the temporary file
+      serializer_.reset();
+      bool ok = sstream_->good();
+      sstream_.reset();
+      if (!ok) {
+        std::remove(tmp_name_.c_str());
+        casadi_error("Could not write '" + tmp_name_ + "'.");
+      }
+      // Replace the target, readers of the old file keep their copy
+#ifdef _WIN32
+      ok = MoveFileExA(tmp_name_.c_str(), fname_.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else // _WIN32
+      ok = std::rename(tmp_name_.c_str(), fname_.c_str())==0;
+#endif // _WIN32
+      if (!ok) {
+        std::remove(tmp_name_.c_str());
+        casadi_error("Could not replace '" + fname_ + "' by '" + tmp_name_ + "'.");
+      }
+    }
+
+    void FileSerializer::discard() {
+      if (!serializer_) return;
+      serializer_.reset();
+      sstream_.reset();
+      std::remove(tmp_name_.c_str());
+    }
+
     FileSerializer::~FileSerializer() {
+      try {
+        finalize();
+      } catch (std::exception& e) {
+        casadi_warning(e.what());
+      }
     }
 
     std::string StringSerializer::encode() {
+      serializer_->flush();
       std::string ret = static_cast<std::stringstream*>(sstream_.get())->str();
       static_cast<std::stringstream*>(sstream_.get())->str("");
       sstream_->clear();
       return ret;
     }
     void StringDeserializer::decode(const std::string& string) {
-      casadi_assert(dstream_->peek() == std::char_traits<char>::eof(),
+      casadi_assert(deserializer_->exhausted(),
         "StringDeserializer::decode does not apply: current string not fully consumed yet.");
       static_cast<std::stringstream*>(dstream_.get())->str(string);
       dstream_->clear(); // reset error flags
@@ -107,8 +172,7 @@ namespace casadi {
     }
 
     FileDeserializer::FileDeserializer(const std::string& fname) :
-        DeserializerBase(std::unique_ptr<std::istream>(
-          new std::ifstream(fname, std::ios_base::binary | std::ios::in))) {
+        DeserializerBase(std::unique_ptr<std::istream>(new MappedIStream(fname))) {
       if ((dstream_->rdstate() & std::ifstream::failbit) != 0) {
         casadi_error("Could not open file '" + fname + "' for reading.");
       }
@@ -124,11 +188,12 @@ namespace casadi {
     FileDeserializer::~FileDeserializer() { }
 
     SerializingStream& SerializerBase::serializer() {
+      casadi_assert(serializer_!=nullptr, "Serializer has already been finalized");
       return *serializer_;
     }
 
     DeserializingStream& DeserializerBase::deserializer() {
-      casadi_assert(dstream_->peek() != std::char_traits<char>::eof(),
+      casadi_assert(!deserializer_->exhausted(),
         "Deserializer reached end of stream. Nothing left to unpack.");
       return *deserializer_;
     }
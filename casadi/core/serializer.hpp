@@ -223,11 +223,31 @@ namespace casadi {
   public:
     /** \brief Advanced serialization of CasADi objects
      * 
+     * The data is written to a temporary file in the same directory, which replaces
+     * \a fname in finalize, or when the serializer is destroyed. Processes reading \a fname
+     * concurrently, e.g. through the memory mapping of FileDeserializer, keep seeing the
+     * old contents.
+     *
      * \see StringSerializer, FileDeserializer
 
         \identifier{7q} */
     FileSerializer(const std::string& fname, const Dict& opts = Dict());
     ~FileSerializer();
+
+    /** \brief Replace the target file by the data packed so far
+     *
+     * Raises an error on failure. No further objects can be packed.
+     */
+    void finalize();
+
+    /** \brief Remove the data packed so far, leaving the target file untouched
+     */
+    void discard();
+
+  private:
+    FileSerializer(const std::string& fname, const std::string& tmp_name, const Dict& opts);
+    // Target file and temporary file being written
+    std::string fname_, tmp_name_;
   };
 
   class CASADI_EXPORT StringDeserializer : public DeserializerBase {
@@ -252,6 +272,9 @@ namespace casadi {
   public:
      /** \brief Advanced deserialization of CasADi objects
      * 
+     * The file is memory-mapped read-only. The deserialized objects are still copied
+     * out of the mapping, so they do not share memory with other processes.
+     *
      * \see FileSerializer
 
          \identifier{7t} */
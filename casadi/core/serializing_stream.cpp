@@ -38,12 +38,111 @@
 #include "function_internal.hpp"
 #include "fmu_impl.hpp" // Not sure why this is needed and importer_internal.hpp is not
 #include <iomanip>
+#include <cstring>
 
 namespace casadi {
 
+    // Protocol version of the text-safe and binary formats
     static casadi_int serialization_protocol_version = 3;
+    static casadi_int serialization_protocol_version_binary = 4;
     static casadi_int serialization_check = 123456789012345;
 
+    // Uncompressed size of a compressed block
+    static const size_t serialization_block_size = 1 << 20;
+
+    // Flag for blocks stored without compression
+    static const uint32_t serialization_block_stored = uint32_t(1) << 31;
+
+    // Append a length in LZ4-style encoding: a run of 255, then the remainder
+    static void lz_put_length(size_t len, std::string& dst) {
+      for (; len>=255; len-=255) dst.push_back(static_cast<char>(255));
+      dst.push_back(static_cast<char>(len));
+    }
+
+    // Append a sequence of literals followed by an (optional) match
+    static void lz_put_sequence(const char* lit, size_t n_lit, size_t offset, size_t len,
+        std::string& dst) {
+      unsigned char token = static_cast<unsigned char>(std::min(n_lit, size_t(15)) << 4);
+      if (len) token |= static_cast<unsigned char>(std::min(len-4, size_t(15)));
+      dst.push_back(static_cast<char>(token));
+      if (n_lit>=15) lz_put_length(n_lit-15, dst);
+      dst.append(lit, n_lit);
+      if (len) {
+        dst.push_back(static_cast<char>(offset & 0xff));
+        dst.push_back(static_cast<char>(offset >> 8));
+        if (len-4>=15) lz_put_length(len-4-15, dst);
+      }
+    }
+
+    // LZ77 block compression with an LZ4-like sequence format, greedy parsing
+    static void lz_compress(const char* src, size_t n, std::string& dst) {
+      const int hash_bits = 16;
+      std::vector<int64_t> table(size_t(1) << hash_bits, -1);
+      size_t anchor = 0, i = 0;
+      while (i+4<=n) {
+        uint32_t v;
+        std::memcpy(&v, src+i, 4);
+        uint32_t h = (v * 2654435761u) >> (32-hash_bits);
+        int64_t cand = table[h];
+        table[h] = static_cast<int64_t>(i);
+        if (cand>=0 && i-cand<=0xffff && std::memcmp(src+cand, src+i, 4)==0) {
+          size_t len = 4;
+          while (i+len<n && src[cand+len]==src[i+len]) len++;
+          lz_put_sequence(src+anchor, i-anchor, i-cand, len, dst);
+          i += len;
+          anchor = i;
+        } else {
+          i++;
+        }
+      }
+      // Trailing literals
+      lz_put_sequence(src+anchor, n-anchor, 0, 0, dst);
+    }
+
+    // Read a length in LZ4-style encoding
+    static size_t lz_get_length(const unsigned char*& p, const unsigned char* end) {
+      size_t len = 0;
+      unsigned char c;
+      do {
+        casadi_assert(p<end, "Corrupt compressed block");
+        c = *p++;
+        len += c;
+      } while (c==255);
+      return len;
+    }
+
+    // Inverse of lz_compress
+    static void lz_decompress(const char* src, size_t n, std::string& dst) {
+      const unsigned char* p = reinterpret_cast<const unsigned char*>(src);
+      const unsigned char* end = p + n;
+      size_t n_dst = dst.size();
+      size_t k = 0;
+      while (p<end) {
+        unsigned char token = *p++;
+        // Literals
+        size_t n_lit = token >> 4;
+        if (n_lit==15) n_lit += lz_get_length(p, end);
+        casadi_assert(n_lit<=static_cast<size_t>(end-p) && k+n_lit<=n_dst,
+          "Corrupt compressed block");
+        std::memcpy(&dst[k], p, n_lit);
+        p += n_lit;
+        k += n_lit;
+        // Last sequence has no match
+        if (p==end) break;
+        // Match
+        casadi_assert(end-p>=2, "Corrupt compressed block");
+        size_t offset = p[0] | (p[1] << 8);
+        p += 2;
+        size_t len = token & 15;
+        if (len==15) len += lz_get_length(p, end);
+        len += 4;
+        casadi_assert(offset>0 && offset<=k && k+len<=n_dst, "Corrupt compressed block");
+        // Byte by byte, the match may overlap with its own output
+        for (size_t j=0; j<len; ++j, ++k) dst[k] = dst[k-offset];
+      }
+      casadi_assert(k==n_dst, "Corrupt compressed block");
+    }
+
     DeserializingStream::DeserializingStream(std::istream& in_s) : in(in_s), debug_(false) {
 
       casadi_assert(in_s.good(), "Invalid input stream. If you specified an input file, "
@@ -66,14 +165,23 @@ namespace casadi {
       // API version check
       casadi_int v;
       unpack(v);
-      casadi_assert(v==serialization_protocol_version,
+      casadi_assert(v==serialization_protocol_version || v==serialization_protocol_version_binary,
         "Serialization protocol is not compatible. "
         "Got version " + str(v) + ", while " +
-        str(serialization_protocol_version) + " was expected.");
+        str(serialization_protocol_version) + " or " +
+        str(serialization_protocol_version_binary) + " was expected.");
 
       bool debug;
       unpack(debug);
       debug_ = debug;
+
+      // Binary format: remainder of the stream is raw, possibly compressed, data
+      if (v==serialization_protocol_version_binary) {
+        bool compress;
+        unpack(compress);
+        binary_ = true;
+        compress_ = compress;
+      }
       set_up_ = true;
     }
 
@@ -83,24 +191,165 @@ namespace casadi {
 
     SerializingStream::SerializingStream(std::ostream& out_s, const Dict& opts) :
         out(out_s), debug_(false) {
-      // Sanity check
-      pack(serialization_check);
-      // API version check
-      pack(casadi_int(serialization_protocol_version));
-
-      bool debug = false;
+      bool debug = false, binary = false, compress = false;
 
       // Read options
       for (auto&& op : opts) {
         if (op.first=="debug") {
           debug = op.second;
+        } else if (op.first=="binary") {
+          binary = op.second;
+        } else if (op.first=="compress") {
+          compress = op.second;
         } else {
           casadi_error("Unknown option: '" + op.first + "'.");
         }
       }
+      // Compression only applies to the binary format
+      if (compress) binary = true;
+
+      // Sanity check
+      pack(serialization_check);
+      // API version check
+      pack(binary ? serialization_protocol_version_binary : serialization_protocol_version);
 
       pack(debug);
       debug_ = debug;
+
+      if (binary) {
+        pack(compress);
+        binary_ = true;
+        compress_ = compress;
+      }
+    }
+
+    SerializingStream::~SerializingStream() {
+      try {
+        flush();
+      } catch (std::exception& e) {
+        casadi_warning("Failed to flush serialized data: " + std::string(e.what()));
+      }
+    }
+
+    void SerializingStream::flush() {
+      if (!compress_ || block_.empty()) return;
+      // Compress, store uncompressed if this does not pay off
+      std::string c;
+      c.reserve(block_.size());
+      lz_compress(block_.data(), block_.size(), c);
+      uint32_t h[2];
+      h[0] = static_cast<uint32_t>(block_.size());
+      const std::string& data = c.size()<block_.size() ? c : block_;
+      h[1] = static_cast<uint32_t>(data.size());
+      if (&data==&block_) h[1] |= serialization_block_stored;
+      out.write(reinterpret_cast<const char*>(h), sizeof(h));
+      out.write(data.data(), data.size());
+      block_.clear();
+    }
+
+    void DeserializingStream::read_block() {
+      uint32_t h[2];
+      in.read(reinterpret_cast<char*>(h), sizeof(h));
+      casadi_assert(in.gcount()==sizeof(h), "DeserializingStream: unexpected end of stream.");
+      bool stored = h[1] & serialization_block_stored;
+      size_t n = h[1] & ~serialization_block_stored;
+      std::string data(n, '\0');
+      in.read(&data[0], n);
+      casadi_assert(static_cast<size_t>(in.gcount())==n,
+        "DeserializingStream: unexpected end of stream.");
+      if (stored) {
+        block_ = std::move(data);
+      } else {
+        block_.assign(h[0], '\0');
+        lz_decompress(data.data(), n, block_);
+      }
+      block_pos_ = 0;
+    }
+
+    void SerializingStream::pack_raw(const char* c, size_t n) {
+      if (compress_) {
+        // Collect blocks for compression
+        while (n>0) {
+          size_t k = std::min(n, serialization_block_size - block_.size());
+          block_.append(c, k);
+          c += k;
+          n -= k;
+          if (block_.size()==serialization_block_size) flush();
+        }
+      } else if (binary_) {
+        out.write(c, n);
+      } else {
+        // Text-safe: each byte as two characters 'a'+nibble, low nibble first
+        // Note: outputstreams work neatly with std::hex, but inputstreams don't
+        const unsigned char ref = 'a';
+        char buf[1024];
+        while (n>0) {
+          size_t k = std::min(n, sizeof(buf)/2);
+          for (size_t j=0; j<k; ++j) {
+            unsigned char e = static_cast<unsigned char>(c[j]);
+            buf[2*j] = static_cast<char>(ref + (e % 16));
+            buf[2*j+1] = static_cast<char>(ref + (e >> 4));
+          }
+          out.write(buf, 2*k);
+          c += k;
+          n -= k;
+        }
+      }
+    }
+
+    void DeserializingStream::unpack_raw(char* c, size_t n) {
+      if (compress_) {
+        while (n>0) {
+          if (block_pos_==block_.size()) read_block();
+          size_t k = std::min(n, block_.size() - block_pos_);
+          std::memcpy(c, &block_[block_pos_], k);
+          block_pos_ += k;
+          c += k;
+          n -= k;
+        }
+      } else if (binary_) {
+        in.read(c, n);
+        casadi_assert(static_cast<size_t>(in.gcount())==n,
+          "DeserializingStream: unexpected end of stream.");
+      } else {
+        const unsigned char ref = 'a';
+        char buf[1024];
+        while (n>0) {
+          size_t k = std::min(n, sizeof(buf)/2);
+          in.read(buf, 2*k);
+          casadi_assert(static_cast<size_t>(in.gcount())==2*k,
+            "DeserializingStream: unexpected end of stream.");
+          for (size_t j=0; j<k; ++j) {
+            unsigned char lo = static_cast<unsigned char>(buf[2*j]) - ref;
+            unsigned char hi = static_cast<unsigned char>(buf[2*j+1]) - ref;
+            c[j] = static_cast<char>(lo + (hi << 4));
+          }
+          c += k;
+          n -= k;
+        }
+      }
+    }
+
+    void DeserializingStream::skip_raw(size_t n) {
+      if (compress_) {
+        while (n>0) {
+          if (block_pos_==block_.size()) read_block();
+          size_t k = std::min(n, block_.size() - block_pos_);
+          block_pos_ += k;
+          n -= k;
+        }
+      } else {
+        // Two characters per byte in the text-safe format
+        size_t n_char = binary_ ? n : 2*n;
+        in.ignore(static_cast<std::streamsize>(n_char));
+        casadi_assert(static_cast<size_t>(in.gcount())==n_char,
+          "DeserializingStream: unexpected end of stream.");
+      }
+    }
+
+    bool DeserializingStream::exhausted() {
+      if (block_pos_<block_.size()) return false;
+      return in.peek() == std::char_traits<char>::eof();
     }
 
     void SerializingStream::decorate(char e) {
@@ -118,66 +367,54 @@ namespace casadi {
     void DeserializingStream::unpack(casadi_int& e) {
       assert_decoration('J');
       int64_t n;
-      char* c = reinterpret_cast<char*>(&n);
-
-      for (int j=0;j<8;++j) unpack(c[j]);
+      unpack_raw(reinterpret_cast<char*>(&n), 8);
       e = n;
     }
 
     void SerializingStream::pack(casadi_int e) {
       decorate('J');
       int64_t n = e;
-      const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<8;++j) pack(c[j]);
+      pack_raw(reinterpret_cast<const char*>(&n), 8);
     }
 
     void SerializingStream::pack(size_t e) {
       decorate('K');
       uint64_t n = e;
-      const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<8;++j) pack(c[j]);
+      pack_raw(reinterpret_cast<const char*>(&n), 8);
     }
 
     void DeserializingStream::unpack(size_t& e) {
       assert_decoration('K');
       uint64_t n;
-      char* c = reinterpret_cast<char*>(&n);
-
-      for (int j=0;j<8;++j) unpack(c[j]);
+      unpack_raw(reinterpret_cast<char*>(&n), 8);
       e = n;
     }
 
     void DeserializingStream::unpack(int& e) {
       assert_decoration('i');
       int32_t n;
-      char* c = reinterpret_cast<char*>(&n);
-
-      for (int j=0;j<4;++j) unpack(c[j]);
+      unpack_raw(reinterpret_cast<char*>(&n), 4);
       e = n;
     }
 
     void SerializingStream::pack(int e) {
       decorate('i');
       int32_t n = e;
-      const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<4;++j) pack(c[j]);
+      pack_raw(reinterpret_cast<const char*>(&n), 4);
     }
 
 #if SIZE_MAX != UINT_MAX || defined(__EMSCRIPTEN__)
     void DeserializingStream::unpack(unsigned int& e) {
       assert_decoration('u');
       uint32_t n;
-      char* c = reinterpret_cast<char*>(&n);
-
-      for (int j=0;j<4;++j) unpack(c[j]);
+      unpack_raw(reinterpret_cast<char*>(&n), 4);
       e = n;
     }
 
     void SerializingStream::pack(unsigned int e) {
       decorate('u');
       uint32_t n = e;
-      const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<4;++j) pack(c[j]);
+      pack_raw(reinterpret_cast<const char*>(&n), 4);
     }
 #endif
 
@@ -194,28 +431,18 @@ namespace casadi {
     }
 
     void DeserializingStream::unpack(char& e) {
-      unsigned char ref = 'a';
-      in.get(e);
-      char t;
-      in.get(t);
-      e = (reinterpret_cast<unsigned char&>(e)-ref) +
-          ((reinterpret_cast<unsigned char&>(t)-ref) << 4);
+      unpack_raw(&e, 1);
     }
 
     void SerializingStream::pack(char e) {
-      unsigned char ref = 'a';
-      // Note: outputstreams work neatly with std::hex,
-      // but inputstreams don't
-      out.put(ref + (reinterpret_cast<unsigned char&>(e) % 16));
-      out.put(ref + (reinterpret_cast<unsigned char&>(e) >> 4));
+      pack_raw(&e, 1);
     }
 
     void SerializingStream::pack(const std::string& e) {
       decorate('s');
       int s = static_cast<int>(e.size());
       pack(s);
-      const char* c = e.c_str();
-      for (int j = 0; j < s; ++j) pack(c[j]);
+      pack_raw(e.data(), s);
     }
 
     void DeserializingStream::unpack(std::string& e) {
@@ -223,19 +450,85 @@ namespace casadi {
       int s;
       unpack(s);
       e.resize(s);
-      for (int j=0;j<s;++j) unpack(e[j]);
+      if (s>0) unpack_raw(&e[0], s);
     }
 
     void DeserializingStream::unpack(double& e) {
       assert_decoration('d');
-      char* c = reinterpret_cast<char*>(&e);
-      for (int j=0;j<8;++j) unpack(c[j]);
+      unpack_raw(reinterpret_cast<char*>(&e), 8);
     }
 
     void SerializingStream::pack(double e) {
       decorate('d');
-      const char* c = reinterpret_cast<const char*>(&e);
-      for (int j=0;j<8;++j) pack(c[j]);
+      pack_raw(reinterpret_cast<const char*>(&e), 8);
+    }
+
+    // Vectors of numbers are written in bulk when there are no per-element decorations,
+    // producing the same bytes as element-wise packing
+    void SerializingStream::pack(const std::vector<double>& e) {
+      decorate('V');
+      pack(static_cast<casadi_int>(e.size()));
+      if (debug_) {
+        for (double i : e) pack(i);
+      } else {
+        pack_raw(reinterpret_cast<const char*>(e.data()), 8*e.size());
+      }
+    }
+
+    void DeserializingStream::unpack(std::vector<double>& e) {
+      assert_decoration('V');
+      casadi_int s;
+      unpack(s);
+      e.resize(s);
+      if (debug_) {
+        for (double& i : e) unpack(i);
+      } else {
+        unpack_raw(reinterpret_cast<char*>(e.data()), 8*e.size());
+      }
+    }
+
+    void SerializingStream::pack(const std::vector<casadi_int>& e) {
+      decorate('V');
+      pack(static_cast<casadi_int>(e.size()));
+      if (debug_ || sizeof(casadi_int)!=8) {
+        for (casadi_int i : e) pack(i);
+      } else {
+        pack_raw(reinterpret_cast<const char*>(e.data()), 8*e.size());
+      }
+    }
+
+    void DeserializingStream::unpack(std::vector<casadi_int>& e) {
+      assert_decoration('V');
+      casadi_int s;
+      unpack(s);
+      e.resize(s);
+      if (debug_ || sizeof(casadi_int)!=8) {
+        for (casadi_int& i : e) unpack(i);
+      } else {
+        unpack_raw(reinterpret_cast<char*>(e.data()), 8*e.size());
+      }
+    }
+
+    void SerializingStream::pack(const std::vector<int>& e) {
+      decorate('V');
+      pack(static_cast<casadi_int>(e.size()));
+      if (debug_ || sizeof(int)!=4) {
+        for (int i : e) pack(i);
+      } else {
+        pack_raw(reinterpret_cast<const char*>(e.data()), 4*e.size());
+      }
+    }
+
+    void DeserializingStream::unpack(std::vector<int>& e) {
+      assert_decoration('V');
+      casadi_int s;
+      unpack(s);
+      e.resize(s);
+      if (debug_ || sizeof(int)!=4) {
+        for (int& i : e) unpack(i);
+      } else {
+        unpack_raw(reinterpret_cast<char*>(e.data()), 4*e.size());
+      }
     }
 
     void SerializingStream::pack(const Sparsity& e) {
@@ -328,9 +621,7 @@ namespace casadi {
       for (size_t i=0;i<len;++i) {
         s.read(buffer, 1024);
         size_t c = s.gcount();
-        for (size_t j=0;j<c;++j) {
-          pack(buffer[j]);
-        }
+        pack_raw(buffer, c);
         if (s.rdstate() & std::ifstream::eofbit) break;
       }
     }
@@ -339,11 +630,25 @@ namespace casadi {
       assert_decoration('B');
       size_t len;
       unpack(len);
-      for (size_t i=0;i<len;++i) {
-        char c;
-        unpack(c);
-        s.put(c);
+      char buffer[1024];
+      while (len>0) {
+        size_t c = std::min(len, sizeof(buffer));
+        unpack_raw(buffer, c);
+        s.write(buffer, c);
+        len -= c;
+      }
+    }
+
+    void DeserializingStream::skip_blob(const std::string& descr) {
+      if (debug_) {
+        std::string d;
+        unpack(d);
+        casadi_assert(d==descr, "Mismatch: '" + descr + "' expected, got '" + d + "'.");
       }
+      assert_decoration('B');
+      size_t len;
+      unpack(len);
+      skip_raw(len);
     }
 
     void SerializingStream::pack(const Slice& e) {
@@ -431,7 +736,7 @@ namespace casadi {
     if (!node) return;
     if (is_sx) {
       if (--static_cast<SXNode*>(node)->count == 0) {
-        delete static_cast<SXNode*>(node);
+        SXNode::destroy(static_cast<SXNode*>(node));
       }
     } else {
       if (--static_cast<SharedObjectInternal*>(node)->count == 0) {
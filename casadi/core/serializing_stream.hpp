@@ -112,6 +112,9 @@ namespace casadi {
     void unpack(std::string& e);
     void unpack(double& e);
     void unpack(char& e);
+    void unpack(std::vector<double>& e);
+    void unpack(std::vector<casadi_int>& e);
+    void unpack(std::vector<int>& e);
     template <class T>
     void unpack(std::vector<T>& e) {
       assert_decoration('V');
@@ -161,7 +164,23 @@ namespace casadi {
     void connect(SerializingStream & s);
     void reset();
 
+    /// Has all data in the stream been consumed?
+    bool exhausted();
+
+    /// Skip over data packed from an std::istream, without copying it
+    void skip_blob(const std::string& descr);
+
   private:
+    /** \brief Read raw bytes
+     *
+     * Decodes the text-safe format or reads (decompressed) binary data */
+    void unpack_raw(char* c, size_t n);
+
+    /// Skip raw bytes
+    void skip_raw(size_t n);
+
+    /// Read and decompress the next block
+    void read_block();
 
     /** \brief Unpacks a shared object
     *
@@ -205,6 +224,13 @@ namespace casadi {
     std::istream& in;
     /// Debug mode?
     bool debug_;
+    /// Raw binary data?
+    bool binary_ = false;
+    /// Block compression?
+    bool compress_ = false;
+    /// Decompressed block and read position
+    std::string block_;
+    size_t block_pos_ = 0;
     /// Did setup ran?
     bool set_up_ = false;
   };
@@ -219,10 +245,17 @@ namespace casadi {
   class CASADI_EXPORT SerializingStream {
     friend class DeserializingStream;
   public:
-    /// Constructor
+    /** \brief Constructor
+
+        Options: "debug" (bool) adds type information for checking during deserialization,
+        "binary" (bool) writes raw binary data instead of the default text-safe encoding and
+        "compress" (bool) additionally applies LZ block compression to the binary data. */
     SerializingStream(std::ostream& out);
     SerializingStream(std::ostream& out, const Dict& opts);
 
+    /// Destructor, flushes pending data
+    ~SerializingStream();
+
     // @{
     /** \brief Serializes an object to the output stream
 
@@ -252,6 +285,9 @@ namespace casadi {
     void pack(double e);
     void pack(const std::string& e);
     void pack(char e);
+    void pack(const std::vector<double>& e);
+    void pack(const std::vector<casadi_int>& e);
+    void pack(const std::vector<int>& e);
     template <class T>
     void pack(const std::vector<T>& e) {
       decorate('V');
@@ -290,7 +326,15 @@ namespace casadi {
     void connect(DeserializingStream & s);
     void reset();
 
+    /// Write pending compressed data to the output stream
+    void flush();
+
   private:
+    /** \brief Write raw bytes
+     *
+     * Encodes in the text-safe format or writes (compressed) binary data */
+    void pack_raw(const char* c, size_t n);
+
     /** \brief Insert information for a primitive typecheck during deserialization
      *
      * No-op unless in debug mode
@@ -326,6 +370,12 @@ namespace casadi {
     std::ostream& out;
     /// Debug mode?
     bool debug_;
+    /// Raw binary data?
+    bool binary_ = false;
+    /// Block compression?
+    bool compress_ = false;
+    /// Data not yet compressed
+    std::string block_;
   };
 
   template <>
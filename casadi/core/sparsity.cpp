@@ -29,6 +29,7 @@
 #include "casadi_misc.hpp"
 #include "serializing_stream.hpp"
 #include "filesystem_impl.hpp"
+#include "global_options.hpp"
 #include <climits>
 
 #define CASADI_THROW_ERROR(FNAME, WHAT) \
@@ -37,6 +38,9 @@ throw CasadiException("Error in Sparsity::" FNAME " at " + CASADI_WHERE + ":\n"\
 
 namespace casadi {
   /// \cond INTERNAL
+  // Smallest number of columns colored in parallel with GlobalOptions::coloring_threads
+  static const casadi_int parallel_coloring_min_size = 1000;
+
   // Singletons
   class EmptySparsity : public Sparsity {
   public:
@@ -521,9 +525,72 @@ namespace casadi {
     }
   }
 
-  Sparsity::CachingMap& Sparsity::getCache() {
-    static CachingMap ret;
-    return ret;
+  /* Hashing of sparsity patterns: the nonzeros are visited column by column, each index
+   * costing one xor and one multiplication (FNV-1a on whole words). The avalanche step at the
+   * end (from MurmurHash3) spreads the entropy over all bits, as needed for the cache shards.
+   */
+  inline uint64_t hash_sparsity_step(uint64_t h, casadi_int v) {
+    return (h ^ static_cast<uint64_t>(v)) * 0x100000001b3ULL;
+  }
+
+  inline uint64_t hash_sparsity_init(casadi_int nrow, casadi_int ncol) {
+    return hash_sparsity_step(hash_sparsity_step(0xcbf29ce484222325ULL, nrow), ncol);
+  }
+
+  inline std::size_t hash_sparsity_final(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+  }
+
+  /// Number of independently locked parts of the sparsity pattern cache
+  static const casadi_int n_cache_shards = 64;
+
+  struct Sparsity::CacheShard {
+    // Cached patterns, by hash value
+    CachingMap cache;
+    // Number of lookups that found, or did not find, a cached pattern
+    casadi_int hits, misses;
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+    // Safe access to the shard
+    std::mutex mtx;
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
+    CacheShard() : hits(0), misses(0) {}
+  };
+
+  Sparsity::CacheShard& Sparsity::cache_shard(std::size_t h) {
+    static CacheShard shards[n_cache_shards];
+    // Top bits select the shard, the low bits select the bucket within the shard
+    return shards[(h >> (8*sizeof(std::size_t) - 6)) % n_cache_shards];
+  }
+
+  Dict Sparsity::cache_stats() {
+    casadi_int hits = 0, misses = 0, entries = 0, alive = 0, bytes = 0;
+    for (casadi_int s=0; s<n_cache_shards; ++s) {
+      // Any hash value whose top bits equal s
+      CacheShard& shard = cache_shard(static_cast<std::size_t>(s) << (8*sizeof(std::size_t) - 6));
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+      std::lock_guard<std::mutex> lock(shard.mtx);
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
+      hits += shard.hits;
+      misses += shard.misses;
+      entries += shard.cache.size();
+      for (auto&& e : shard.cache) {
+        SharedObject ref_shared;
+        if (e.second.shared_if_alive(ref_shared)) {
+          Sparsity ref = shared_cast<Sparsity>(ref_shared);
+          alive++;
+          bytes += sizeof(SparsityInternal) + sizeof(casadi_int) * (3 + ref.size2() + ref.nnz());
+        }
+      }
+    }
+    double hit_rate = hits + misses == 0 ? 0 : hits / static_cast<double>(hits + misses);
+    return {{"hits", hits}, {"misses", misses}, {"hit_rate", hit_rate},
+            {"entries", entries}, {"alive", alive}, {"bytes", bytes},
+            {"shards", n_cache_shards}};
   }
 
   const Sparsity& Sparsity::getScalar() {
@@ -747,6 +814,9 @@ namespace casadi {
   }
 
   Sparsity Sparsity::uni_coloring(const Sparsity& AT, casadi_int cutoff) const {
+    if (GlobalOptions::coloring_threads!=1 && size2()>=parallel_coloring_min_size) {
+      return uni_coloring_parallel(AT, cutoff, GlobalOptions::coloring_threads);
+    }
     if (AT.is_null()) {
       return (*this)->uni_coloring(T(), cutoff);
     } else {
@@ -754,10 +824,29 @@ namespace casadi {
     }
   }
 
+  Sparsity Sparsity::uni_coloring_parallel(const Sparsity& AT, casadi_int cutoff,
+      casadi_int num_threads) const {
+    casadi_assert(num_threads>=0, "Number of threads must be nonnegative");
+    if (AT.is_null()) {
+      return (*this)->uni_coloring_parallel(T(), cutoff, num_threads);
+    } else {
+      return (*this)->uni_coloring_parallel(AT, cutoff, num_threads);
+    }
+  }
+
   Sparsity Sparsity::star_coloring(casadi_int ordering, casadi_int cutoff) const {
+    if (GlobalOptions::coloring_threads!=1 && size2()>=parallel_coloring_min_size) {
+      return star_coloring_parallel(ordering, cutoff, GlobalOptions::coloring_threads);
+    }
     return (*this)->star_coloring(ordering, cutoff);
   }
 
+  Sparsity Sparsity::star_coloring_parallel(casadi_int ordering, casadi_int cutoff,
+      casadi_int num_threads) const {
+    casadi_assert(num_threads>=0, "Number of threads must be nonnegative");
+    return (*this)->star_coloring_parallel(ordering, cutoff, num_threads);
+  }
+
   Sparsity Sparsity::star_coloring2(casadi_int ordering, casadi_int cutoff) const {
     return (*this)->star_coloring2(ordering, cutoff);
   }
@@ -828,16 +917,16 @@ namespace casadi {
                   "Compressed Column Storage is not sane. "
                   "First element of colind must be zero.");
 
-    // Make sure colind is montone
-    for (casadi_int c=0; c<ncol; c++) {
+    // Check the pattern and hash it in a single pass
+    bool rows_ordered = true;
+    uint64_t h = hash_sparsity_init(nrow, ncol);
+    for (casadi_int c=0; c<ncol; ++c) {
+      // Make sure colind is montone
       casadi_assert(colind[c+1]>=colind[c],
                     "Compressed Column Storage is not sane. "
                     "colind must be monotone.");
-    }
-
-    // Check if rows correct and ordered without duplicates
-    bool rows_ordered = true;
-    for (casadi_int c=0; c<ncol; ++c) {
+      h = hash_sparsity_step(h, colind[c+1]);
+      // Check if rows correct and ordered without duplicates
       casadi_int last_r = -1;
       for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
         casadi_int r = row[k];
@@ -849,6 +938,7 @@ namespace casadi {
         // Check if ordered
         if (r<=last_r) rows_ordered = false;
         last_r = r;
+        h = hash_sparsity_step(h, r);
       }
     }
 
@@ -870,16 +960,17 @@ namespace casadi {
       return;
     }
 
-    // Hash the pattern
-    std::size_t h = hash_sparsity(nrow, ncol, colind, row);
+    // Hash value of the pattern, same as hash_sparsity
+    std::size_t hv = hash_sparsity_final(h);
 
+    // Only the part of the cache that can hold the pattern is locked
+    CacheShard& shard = cache_shard(hv);
 #ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
-    // Safe access to CachingMap
-    std::lock_guard<std::mutex> lock(cachingmap_mtx);
+    std::lock_guard<std::mutex> lock(shard.mtx);
 #endif // CASADI_WITH_THREADSAFE_SYMBOLICS
 
     // Get a reference to the cache
-    CachingMap& cache = getCache();
+    CachingMap& cache = shard.cache;
 
     // Record the current number of buckets (for garbage collection below)
     casadi_int bucket_count_before = cache.bucket_count();
@@ -888,7 +979,7 @@ namespace casadi {
     if (bucket_count_before>0) {
 
       // Find the range of patterns equal to the key (normally only zero or one)
-      std::pair<CachingMap::iterator, CachingMap::iterator> eq = cache.equal_range(h);
+      std::pair<CachingMap::iterator, CachingMap::iterator> eq = cache.equal_range(hv);
 
       // Loop over maching patterns
       for (CachingMap::iterator i=eq.first; i!=eq.second; ++i) {
@@ -910,6 +1001,7 @@ namespace casadi {
 
             // Found match!
             own(ref.get());
+            shard.hits++;
             return;
 
           } else { // There is a hash rowision (unlikely, but possible)
@@ -933,6 +1025,7 @@ namespace casadi {
               // Match found if sparsity matches
               if (ref.is_equal(nrow, ncol, colind, row)) {
                 own(ref.get());
+                shard.hits++;
                 return;
               }
             }
@@ -943,6 +1036,7 @@ namespace casadi {
 
           // Cache this pattern
           wref = *this;
+          shard.misses++;
 
           // Return
           return;
@@ -954,7 +1048,8 @@ namespace casadi {
     own(new SparsityInternal(nrow, ncol, colind, row));
 
     // Cache this pattern
-    cache.insert(std::pair<std::size_t, WeakRef>(h, *this));
+    cache.insert(std::pair<std::size_t, WeakRef>(hv, *this));
+    shard.misses++;
 
     // Garbage collection (currently only supported for unordered_multimap)
     casadi_int bucket_count_after = cache.bucket_count();
@@ -972,10 +1067,6 @@ namespace casadi {
     }
   }
 
-#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
-  std::mutex Sparsity::cachingmap_mtx;
-#endif //CASADI_WITH_THREADSAFE_SYMBOLICS
-
   Sparsity Sparsity::tril(const Sparsity& x, bool includeDiagonal) {
     return x->_tril(includeDiagonal);
   }
@@ -1001,12 +1092,12 @@ namespace casadi {
   std::size_t hash_sparsity(casadi_int nrow, casadi_int ncol,
       const casadi_int* colind, const casadi_int* row) {
     // Condense the sparsity pattern to a single, deterministric number
-    std::size_t ret=0;
-    hash_combine(ret, nrow);
-    hash_combine(ret, ncol);
-    hash_combine(ret, colind, ncol+1);
-    hash_combine(ret, row, colind[ncol]);
-    return ret;
+    uint64_t h = hash_sparsity_init(nrow, ncol);
+    for (casadi_int c=0; c<ncol; ++c) {
+      h = hash_sparsity_step(h, colind[c+1]);
+      for (casadi_int k=colind[c]; k<colind[c+1]; ++k) h = hash_sparsity_step(h, row[k]);
+    }
+    return hash_sparsity_final(h);
   }
 
   Sparsity Sparsity::dense(casadi_int nrow, casadi_int ncol) {
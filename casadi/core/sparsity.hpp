@@ -412,6 +412,14 @@ namespace casadi {
     /** Obtain information about sparsity */
     Dict info() const;
 
+    /** \brief Statistics of the cache of sparsity patterns
+
+        Returns the number of cache hits and misses since start-up, the hit rate,
+        the number of cache entries, the number of these still referenced
+        and an estimate of the memory held by the referenced patterns in bytes.
+     */
+    static Dict cache_stats();
+
     /** Export sparsity pattern to file
     *
     * Supported formats:
@@ -880,13 +888,11 @@ namespace casadi {
 #ifndef SWIG
     typedef std::unordered_multimap<std::size_t, WeakRef> CachingMap;
 
-    /// Cached sparsity patterns
-    static CachingMap& getCache();
+    /// Part of the sparsity pattern cache, guarded by its own lock
+    struct CacheShard;
 
-#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
-    // Safe access to CachingMap
-    static std::mutex cachingmap_mtx;
-#endif //CASADI_WITH_THREADSAFE_SYMBOLICS
+    /// Shard of the cache holding the patterns with a given hash value
+    static CacheShard& cache_shard(std::size_t h);
 
     /// (Dense) scalar
     static const Sparsity& getScalar();
@@ -1075,6 +1081,34 @@ namespace casadi {
     Sparsity star_coloring2(casadi_int ordering = 1,
                             casadi_int cutoff = std::numeric_limits<casadi_int>::max()) const;
 
+    /** \brief Perform a unidirectional coloring in parallel
+
+        Speculative greedy distance-2 coloring: threads color blocks of columns
+        concurrently, conflicts between columns colored in the same round are
+        detected afterwards and resolved by recoloring in the next round
+        (A. H. GEBREMEDHIN, F. MANNE, Scalable parallel graph coloring algorithms,
+        Concurrency: Practice and Experience, 12, 1131-1146 (2000)).
+        The number of colors may differ from uni_coloring.
+
+        num_threads: number of blocks colored concurrently on the thread pool,
+        0 for the size of the pool, 1 for the sequential algorithm */
+    Sparsity uni_coloring_parallel(const Sparsity& AT=Sparsity(),
+                          casadi_int cutoff = std::numeric_limits<casadi_int>::max(),
+                          casadi_int num_threads = 0) const;
+
+    /** \brief Perform a star coloring of a symmetric matrix in parallel
+
+        Speculative counterpart of star_coloring. A vertex avoids every color that would
+        give a conflict with a neighbor or a two-colored path on four vertices through it,
+        conflicts between vertices colored in the same round are resolved in the next round.
+
+        Ordering options: None (0), largest first (1)
+        num_threads: number of blocks colored concurrently on the thread pool,
+        0 for the size of the pool, 1 for the sequential algorithm */
+    Sparsity star_coloring_parallel(casadi_int ordering = 1,
+                            casadi_int cutoff = std::numeric_limits<casadi_int>::max(),
+                            casadi_int num_threads = 0) const;
+
     /** \brief Order the columns by decreasing degree
 
         \identifier{de} */
@@ -27,6 +27,8 @@
 #include "sparsity_internal.hpp"
 #include "casadi_misc.hpp"
 #include "global_options.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
 #include <climits>
 #include <cstdlib>
 #include <cmath>
@@ -3290,6 +3292,257 @@ namespace casadi {
     return Sparsity(size2(), forbiddenColors.size(), ret_colind, ret_row);
   }
 
+  // Marks forbidden colors during speculative coloring
+  struct ColoringScratch {
+    // Stamp of the vertex being colored for each forbidden color
+    std::vector<casadi_int> forbidden;
+    // Number of neighbors with each color
+    std::vector<casadi_int> count, count_stamp;
+    // Current stamp
+    casadi_int stamp = 0;
+
+    // Start a new vertex
+    void next() { stamp++;}
+
+    // Forbid a color
+    void mark(casadi_int c) {
+      if (c>=forbidden.size()) forbidden.resize(c+1, -1);
+      forbidden[c] = stamp;
+    }
+
+    // Is a color forbidden?
+    bool is_forbidden(casadi_int c) const {
+      return c<forbidden.size() && forbidden[c]==stamp;
+    }
+
+    // Smallest color that is not forbidden
+    casadi_int first_allowed() const {
+      casadi_int c = 0;
+      while (is_forbidden(c)) c++;
+      return c;
+    }
+
+    // Counter for a color
+    casadi_int& counter(casadi_int c) {
+      if (c>=count.size()) {
+        count.resize(c+1);
+        count_stamp.resize(c+1, -1);
+      }
+      if (count_stamp[c]!=stamp) {
+        count_stamp[c] = stamp;
+        count[c] = 0;
+      }
+      return count[c];
+    }
+  };
+
+  // Colors assigned so far, -1 if uncolored
+  struct CurrentColor {
+    const std::atomic<casadi_int>* color;
+    casadi_int operator()(casadi_int u) const {
+      return color[u].load(std::memory_order_relaxed);
+    }
+  };
+
+  // Colors as seen when coloring v sequentially: vertices of the
+  // current round that come after v are considered uncolored
+  struct EarlierColor {
+    const std::atomic<casadi_int>* color;
+    const casadi_int* round;
+    casadi_int r, v;
+    casadi_int operator()(casadi_int u) const {
+      if (round[u]==r && u>v) return -1;
+      return color[u].load(std::memory_order_relaxed);
+    }
+  };
+
+  // Distance-2 coloring of the columns of a matrix, as in uni_coloring
+  struct UniColoringRule {
+    const casadi_int *colind, *row, *AT_colind, *AT_row;
+    template<typename ColorOf>
+    void operator()(casadi_int v, const ColorOf& color_of, ColoringScratch& s,
+        bool exact) const {
+      // Columns sharing a row with v
+      for (casadi_int el=colind[v]; el<colind[v+1]; ++el) {
+        casadi_int c = row[el];
+        for (casadi_int el_u=AT_colind[c]; el_u<AT_colind[c+1]; ++el_u) {
+          casadi_int u = AT_row[el_u];
+          if (u==v) continue;
+          casadi_int cu = color_of(u);
+          if (cu>=0) s.mark(cu);
+        }
+      }
+    }
+  };
+
+  // Star coloring of a symmetric matrix: v may not share its color with a neighbor,
+  // nor complete a path on four vertices using only two colors. Unless exact, colors of
+  // vertices at distance two through an uncolored vertex are avoided as in star_coloring.
+  struct StarColoringRule {
+    const casadi_int *colind, *row;
+    template<typename ColorOf>
+    void operator()(casadi_int v, const ColorOf& color_of, ColoringScratch& s,
+        bool exact) const {
+      // Colors of the neighbors, with multiplicity
+      for (casadi_int w_el=colind[v]; w_el<colind[v+1]; ++w_el) {
+        casadi_int w = row[w_el];
+        if (w==v) continue;
+        casadi_int cw = color_of(w);
+        if (cw<0) continue;
+        s.mark(cw);
+        s.counter(cw)++;
+      }
+      for (casadi_int w_el=colind[v]; w_el<colind[v+1]; ++w_el) {
+        casadi_int w = row[w_el];
+        if (w==v) continue;
+        casadi_int cw = color_of(w);
+        if (cw<0 && exact) continue;
+        // Another neighbor of v has the color of w: path a-v-w-x
+        bool twice = cw>=0 && s.counter(cw)>=2;
+        for (casadi_int x_el=colind[w]; x_el<colind[w+1]; ++x_el) {
+          casadi_int x = row[x_el];
+          if (x==v || x==w) continue;
+          casadi_int cx = color_of(x);
+          if (cx<0) continue;
+          if (cw<0 || twice) {
+            s.mark(cx);
+            continue;
+          }
+          // Path v-w-x-y with y colored as w
+          for (casadi_int y_el=colind[x]; y_el<colind[x+1]; ++y_el) {
+            casadi_int y = row[y_el];
+            if (y==x || y==w || y==v) continue;
+            if (color_of(y)==cw) {
+              s.mark(cx);
+              break;
+            }
+          }
+        }
+      }
+    }
+  };
+
+  /* Speculative parallel greedy coloring (Gebremedhin-Manne)
+   * In each round, the threads color contiguous blocks of the remaining vertices
+   * concurrently against the colors assigned so far. Afterwards, each vertex is checked
+   * against the colors it would have seen in a sequential sweep over the round. Vertices
+   * failing the check are colored again in the next round. Since the first vertex of a
+   * round always passes, the number of rounds is bounded. Returns false if more than
+   * cutoff colors are needed. The number of threads may exceed the size of the pool.
+   */
+  template<typename Rule>
+  static bool speculative_coloring(casadi_int n, casadi_int cutoff, casadi_int num_threads,
+      const Rule& rule, std::vector<casadi_int>& ret) {
+    // Smallest block of vertices per thread
+    const casadi_int min_block = 256;
+
+    ThreadPool& pool = ThreadPool::global();
+
+    std::vector<std::atomic<casadi_int> > color(n);
+    for (auto& c : color) c.store(-1, std::memory_order_relaxed);
+    std::vector<casadi_int> round(n, -1);
+    std::vector<ColoringScratch> scratch(num_threads);
+    std::vector<std::vector<casadi_int> > conflicts(num_threads);
+    std::atomic<bool> too_many(false);
+
+    // Vertices to be colored in the current round
+    std::vector<casadi_int> todo = range(n);
+    for (casadi_int r=0; !todo.empty(); ++r) {
+      for (casadi_int v : todo) round[v] = r;
+      casadi_int nt = std::min(num_threads, 1 + static_cast<casadi_int>(todo.size())/min_block);
+      casadi_int n_todo = todo.size();
+
+      // Color the vertices speculatively
+      pool.run(nt, [&](casadi_int t) -> int {
+        ColoringScratch& s = scratch[t];
+        CurrentColor color_of{color.data()};
+        for (casadi_int i=t*n_todo/nt; i<(t+1)*n_todo/nt; ++i) {
+          if (too_many.load(std::memory_order_relaxed)) break;
+          casadi_int v = todo[i];
+          s.next();
+          rule(v, color_of, s, false);
+          casadi_int c = s.first_allowed();
+          if (c>=cutoff) {
+            too_many = true;
+            break;
+          }
+          color[v].store(c, std::memory_order_relaxed);
+        }
+        return 0;
+      });
+      if (too_many) return false;
+
+      // A sequential round has no conflicts
+      if (nt==1) break;
+
+      // Detect conflicts
+      pool.run(nt, [&](casadi_int t) -> int {
+        ColoringScratch& s = scratch[t];
+        conflicts[t].clear();
+        for (casadi_int i=t*n_todo/nt; i<(t+1)*n_todo/nt; ++i) {
+          casadi_int v = todo[i];
+          s.next();
+          rule(v, EarlierColor{color.data(), round.data(), r, v}, s, true);
+          if (s.is_forbidden(color[v].load(std::memory_order_relaxed))) {
+            conflicts[t].push_back(v);
+          }
+        }
+        return 0;
+      });
+
+      // Recolor in the next round
+      todo.clear();
+      for (auto&& c : conflicts) {
+        for (casadi_int v : c) {
+          color[v].store(-1, std::memory_order_relaxed);
+          todo.push_back(v);
+        }
+      }
+    }
+
+    ret.resize(n);
+    for (casadi_int i=0; i<n; ++i) ret[i] = color[i].load(std::memory_order_relaxed);
+    return true;
+  }
+
+  Sparsity SparsityInternal::uni_coloring_parallel(const Sparsity& AT, casadi_int cutoff,
+      casadi_int num_threads) const {
+    if (num_threads==0) num_threads = ThreadPool::global().size();
+    if (num_threads==1) return uni_coloring(AT, cutoff);
+    UniColoringRule rule{colind(), row(), AT.colind(), AT.row()};
+    std::vector<casadi_int> color;
+    if (!speculative_coloring(size2(), cutoff, num_threads, rule, color)) return Sparsity();
+    casadi_int num_colors = 0;
+    for (casadi_int c : color) num_colors = std::max(num_colors, c+1);
+    return Sparsity::triplet(size2(), num_colors, range(size2()), color);
+  }
+
+  Sparsity SparsityInternal::star_coloring_parallel(casadi_int ordering, casadi_int cutoff,
+      casadi_int num_threads) const {
+    if (!is_square()) {
+      casadi_message("StarColoring requires a square matrix, got " + dim() + ".");
+    }
+
+    // Reorder, if necessary
+    if (ordering!=0) {
+      casadi_assert_dev(ordering==1);
+      std::vector<casadi_int> ord = largest_first();
+      Sparsity sp_permuted = pmult(ord, true, true, true);
+      Sparsity ret_permuted = sp_permuted.star_coloring_parallel(0, cutoff, num_threads);
+      if (ret_permuted.is_null()) return Sparsity();
+      return ret_permuted.pmult(ord, true, false, false);
+    }
+
+    if (num_threads==0) num_threads = ThreadPool::global().size();
+    if (num_threads==1) return star_coloring(0, cutoff);
+    StarColoringRule rule{colind(), row()};
+    std::vector<casadi_int> color;
+    if (!speculative_coloring(size2(), cutoff, num_threads, rule, color)) return Sparsity();
+    casadi_int num_colors = 0;
+    for (casadi_int c : color) num_colors = std::max(num_colors, c+1);
+    return Sparsity::triplet(size2(), num_colors, range(size2()), color);
+  }
+
   Sparsity SparsityInternal::star_coloring(casadi_int ordering, casadi_int cutoff) const {
     if (!is_square()) {
       // NOTE(@jaeandersson) Why warning and not error?
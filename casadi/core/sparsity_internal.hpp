@@ -733,6 +733,14 @@ namespace casadi {
         \identifier{fp} */
     Sparsity star_coloring2(casadi_int ordering, casadi_int cutoff) const;
 
+    /// Speculative parallel version of uni_coloring
+    Sparsity uni_coloring_parallel(const Sparsity& AT, casadi_int cutoff,
+                                   casadi_int num_threads) const;
+
+    /// Speculative parallel version of star_coloring
+    Sparsity star_coloring_parallel(casadi_int ordering, casadi_int cutoff,
+                                    casadi_int num_threads) const;
+
     /// Order the columns by decreasing degree
     std::vector<casadi_int> largest_first() const;
 
@@ -92,7 +92,7 @@ namespace casadi {
   }
 
   SXElem::~SXElem() {
-    if (--node->count == 0) delete node;
+    if (--node->count == 0) SXNode::destroy(node);
   }
 
   SXElem& SXElem::operator=(const SXElem &scalar) {
@@ -100,7 +100,7 @@ namespace casadi {
     if (node == scalar.node) return *this;
 
     // decrease the counter and delete if this was the last pointer
-    if (--node->count == 0) delete node;
+    if (--node->count == 0) SXNode::destroy(node);
 
     // save the new pointer
     node = scalar.node;
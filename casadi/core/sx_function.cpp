@@ -38,9 +38,24 @@
 #include "casadi_interrupt.hpp"
 #include "serializing_stream.hpp"
 #include "global_options.hpp"
+#include "thread_pool.hpp"
 
 namespace casadi {
 
+  // Opcodes of the compact bytecode
+  enum SXBytecode {
+#define CASADI_SX_BYTECODE_ENUM(OP) BC_##OP,
+    CASADI_SX_BYTECODE_BUILTIN(CASADI_SX_BYTECODE_ENUM)
+#undef CASADI_SX_BYTECODE_ENUM
+    BC_CONST, BC_INPUT, BC_OUTPUT, BC_CALL, BC_END
+  };
+
+  // Loop rolling in code generation: longest block considered
+  static const casadi_int loop_max_block = 256;
+
+  // Loop rolling in code generation: fewest instructions worth a loop
+  static const casadi_int loop_min_instructions = 16;
+
   SXFunction::ExtendedAlgEl::ExtendedAlgEl(const Function& fun) : f(fun) {
     n_dep = f.nnz_in(); n_res = f.nnz_out();
     dep.resize(n_dep); res.resize(n_res, -1);
@@ -62,10 +77,16 @@ namespace casadi {
     // Default (persistent) options
     just_in_time_opencl_ = false;
     just_in_time_sparsity_ = false;
+    sparsity_directions_ = 256;
+    sparsity_threads_ = 0;
+    bytecode_ = false;
+    native_jit_ = false;
+    native_ = nullptr;
   }
 
   SXFunction::~SXFunction() {
     clear_mem();
+    delete native_;
   }
 
   int SXFunction::eval(const double** arg, double** res,
@@ -81,6 +102,39 @@ namespace casadi {
                    + str(free_vars_) + " are free.");
     }
 
+    // Interpreted evaluation, timing each instruction
+    if (profile_instructions_) {
+      InstructionStats& prof = static_cast<XFunctionMemory*>(mem)->instr_stats;
+      if (prof.n_call.size()!=algorithm_.size()) prof.reset(algorithm_.size());
+      casadi_int k = 0;
+      for (auto&& e : algorithm_) {
+        prof.tic();
+        switch (e.op) {
+          CASADI_MATH_FUN_BUILTIN(w[e.i1], w[e.i2], w[e.i0])
+
+        case OP_CONST: w[e.i0] = e.d; break;
+        case OP_INPUT: w[e.i0] = arg[e.i1]==nullptr ? 0 : arg[e.i1][e.i2]; break;
+        case OP_OUTPUT: if (res[e.i0]!=nullptr) res[e.i0][e.i2] = w[e.i1]; break;
+        case OP_CALL:
+          call_fwd(e, arg, res, iw, w);
+        break;
+        default:
+          casadi_error("Unknown operation" + str(e.op));
+        }
+        prof.toc(k++);
+      }
+      return 0;
+    }
+
+    // Generated machine code, if available
+    if (native_) {
+      native_->eval(arg, res, w);
+      return 0;
+    }
+
+    // Compact bytecode, if available
+    if (!bc_op_.empty()) return eval_bytecode(arg, res, iw, w);
+
     // NOTE: The implementation of this function is very delicate. Small changes in the
     // class structure can cause large performance losses. For this reason,
     // the preprocessor macros are used below
@@ -103,6 +157,181 @@ namespace casadi {
     return 0;
   }
 
+  void SXFunction::init_bytecode() {
+    bc_op_.clear();
+    bc_arg_.clear();
+    bc_const_.clear();
+    // Free variables cannot be evaluated numerically
+    if (!bytecode_ || has_free()) return;
+    bc_op_.reserve(algorithm_.size() + 1);
+    bc_arg_.reserve(3 * algorithm_.size());
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      switch (e.op) {
+#define CASADI_SX_BYTECODE_CASE(OP) \
+      case OP: bc_op_.push_back(BC_##OP); break;
+        CASADI_SX_BYTECODE_BUILTIN(CASADI_SX_BYTECODE_CASE)
+#undef CASADI_SX_BYTECODE_CASE
+      case OP_CONST: bc_op_.push_back(BC_CONST); break;
+      case OP_INPUT: bc_op_.push_back(BC_INPUT); break;
+      case OP_OUTPUT: bc_op_.push_back(BC_OUTPUT); break;
+      case OP_CALL: bc_op_.push_back(BC_CALL); break;
+      default:
+        casadi_error("Unknown operation" + str(e.op));
+      }
+      if (e.op==OP_CONST) {
+        // Place in the constant pool
+        bc_arg_.push_back(e.i0);
+        bc_arg_.push_back(static_cast<int>(bc_const_.size()));
+        bc_const_.push_back(e.d);
+      } else if (e.op==OP_CALL) {
+        // Call nodes refer back to the algorithm
+        casadi_assert(k <= std::numeric_limits<int>::max(), "Integer overflow");
+        bc_arg_.push_back(static_cast<int>(k));
+      } else {
+        bc_arg_.push_back(e.i0);
+        bc_arg_.push_back(e.i1);
+        bc_arg_.push_back(e.i2);
+      }
+    }
+    bc_op_.push_back(BC_END);
+  }
+
+  int SXFunction::eval_bytecode(const double** arg, double** res,
+      casadi_int* iw, double* w) const {
+    // Opcode stream, operand stream and constant pool
+    const unsigned char* op = get_ptr(bc_op_);
+    const int* a = get_ptr(bc_arg_);
+    const double* c = get_ptr(bc_const_);
+#if defined(__GNUC__)
+    // Direct threading: jump straight to the implementation of the next opcode
+    static const void* const dispatch[] = {
+#define CASADI_SX_BYTECODE_LABEL(OP) &&label_##OP,
+      CASADI_SX_BYTECODE_BUILTIN(CASADI_SX_BYTECODE_LABEL)
+#undef CASADI_SX_BYTECODE_LABEL
+      &&label_const, &&label_input, &&label_output, &&label_call, &&label_end
+    };
+#define CASADI_SX_BYTECODE_NEXT goto *dispatch[*op++]
+    CASADI_SX_BYTECODE_NEXT;
+#define CASADI_SX_BYTECODE_IMPL(OP) \
+  label_##OP: \
+    BinaryOperationSS<OP>::fcn(w[a[1]], w[a[2]], w[a[0]], 1); \
+    a += 3; \
+    CASADI_SX_BYTECODE_NEXT;
+    CASADI_SX_BYTECODE_BUILTIN(CASADI_SX_BYTECODE_IMPL)
+#undef CASADI_SX_BYTECODE_IMPL
+  label_const:
+    w[a[0]] = c[a[1]];
+    a += 2;
+    CASADI_SX_BYTECODE_NEXT;
+  label_input:
+    w[a[0]] = arg[a[1]]==nullptr ? 0 : arg[a[1]][a[2]];
+    a += 3;
+    CASADI_SX_BYTECODE_NEXT;
+  label_output:
+    if (res[a[0]]!=nullptr) res[a[0]][a[2]] = w[a[1]];
+    a += 3;
+    CASADI_SX_BYTECODE_NEXT;
+  label_call:
+    call_fwd(algorithm_[a[0]], arg, res, iw, w);
+    a += 1;
+    CASADI_SX_BYTECODE_NEXT;
+  label_end:
+    return 0;
+#undef CASADI_SX_BYTECODE_NEXT
+#else // __GNUC__
+    // Portable fallback: switch over the compact opcode stream
+    while (true) {
+      switch (*op++) {
+#define CASADI_SX_BYTECODE_IMPL(OP) \
+      case BC_##OP: \
+        BinaryOperationSS<OP>::fcn(w[a[1]], w[a[2]], w[a[0]], 1); \
+        a += 3; \
+        break;
+        CASADI_SX_BYTECODE_BUILTIN(CASADI_SX_BYTECODE_IMPL)
+#undef CASADI_SX_BYTECODE_IMPL
+      case BC_CONST:
+        w[a[0]] = c[a[1]];
+        a += 2;
+        break;
+      case BC_INPUT:
+        w[a[0]] = arg[a[1]]==nullptr ? 0 : arg[a[1]][a[2]];
+        a += 3;
+        break;
+      case BC_OUTPUT:
+        if (res[a[0]]!=nullptr) res[a[0]][a[2]] = w[a[1]];
+        a += 3;
+        break;
+      case BC_CALL:
+        call_fwd(algorithm_[a[0]], arg, res, iw, w);
+        a += 1;
+        break;
+      case BC_END:
+        return 0;
+      }
+    }
+#endif // __GNUC__
+  }
+
+  void SXFunction::init_native_jit() {
+    delete native_;
+    native_ = nullptr;
+    if (!native_jit_ || has_free()) return;
+    if (!NativeJit::is_supported()) {
+      casadi_warning(name_ + ": Option 'native_jit' is not supported on this platform, "
+                     "falling back to interpreted evaluation.");
+      return;
+    }
+    native_ = new NativeJit();
+    if (!native_->compile(algorithm_)) {
+      casadi_warning(name_ + ": Machine code generation failed (" + native_->error() + "), "
+                     "falling back to interpreted evaluation.");
+      delete native_;
+      native_ = nullptr;
+      return;
+    }
+    if (verbose_) casadi_message(name_ + "::init_native_jit: " + str(native_->code_size())
+                                 + " bytes of machine code");
+  }
+
+  int SXFunction::eval_lanes(const double** arg, double** res, double* w,
+      casadi_int n_lane) const {
+    casadi_assert(has_eval_lanes(), "Batched evaluation not supported for '" + name_ + "'");
+    for (auto&& e : algorithm_) {
+      switch (e.op) {
+      case OP_CONST:
+        std::fill_n(w + e.i0*n_lane, n_lane, e.d);
+        break;
+      case OP_INPUT:
+        {
+          double* f = w + e.i0*n_lane;
+          const double* x = arg[e.i1];
+          if (x==nullptr) {
+            std::fill_n(f, n_lane, 0.);
+          } else {
+            casadi_int stride = nnz_in(e.i1);
+            x += e.i2;
+            for (casadi_int l=0; l<n_lane; ++l, x+=stride) f[l] = *x;
+          }
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[e.i0]!=nullptr) {
+          double* r = res[e.i0] + e.i2;
+          const double* x = w + e.i1*n_lane;
+          casadi_int stride = nnz_out(e.i0);
+          for (casadi_int l=0; l<n_lane; ++l, r+=stride) *r = x[l];
+        }
+        break;
+      default:
+        // One dispatch for all lanes
+        casadi_math<double>::fun(e.op, w + e.i1*n_lane, w + e.i2*n_lane, w + e.i0*n_lane,
+          n_lane);
+      }
+    }
+    return 0;
+  }
+
   bool SXFunction::is_smooth() const {
     // Go through all nodes and check if any node is non-smooth
     for (auto&& a : algorithm_) {
@@ -113,6 +342,35 @@ namespace casadi {
     return true;
   }
 
+  void SXFunction::instruction_labels(std::vector<std::string>& type,
+      std::vector<std::string>& descr) const {
+    type.clear();
+    descr.clear();
+    for (auto&& a : algorithm_) {
+      type.push_back(casadi_math<double>::name(a.op));
+      std::stringstream ss;
+      if (a.op==OP_OUTPUT) {
+        ss << "output[" << a.i0 << "][" << a.i2 << "] = @" << a.i1;
+      } else if (a.op==OP_CALL) {
+        ss << call_.el.at(a.i1).f.name() << "(...)";
+      } else {
+        ss << "@" << a.i0 << " = ";
+        if (a.op==OP_INPUT) {
+          ss << "input[" << a.i1 << "][" << a.i2 << "]";
+        } else if (a.op==OP_CONST) {
+          ss << a.d;
+        } else if (a.op==OP_PARAMETER) {
+          ss << "parameter";
+        } else if (casadi_math<double>::ndeps(a.op)==2) {
+          ss << casadi_math<double>::print(a.op, "@" + str(a.i1), "@" + str(a.i2));
+        } else {
+          ss << casadi_math<double>::print(a.op, "@" + str(a.i1));
+        }
+      }
+      descr.push_back(ss.str());
+    }
+  }
+
   void SXFunction::disp_more(std::ostream &stream) const {
     stream << "Algorithm:";
 
@@ -187,7 +445,9 @@ namespace casadi {
   }
 
   size_t SXFunction::codegen_sz_w(const CodeGenerator& g) const {
-    if (!g.avoid_stack()) return call_.sz_w+call_.sz_w_arg+call_.sz_w_res;
+    if (!g.avoid_stack() && !g.loop_rolling() && codegen_chunk_size(g)==0) {
+      return call_.sz_w+call_.sz_w_arg+call_.sz_w_res;
+    }
     return sz_w();
   }
 
@@ -203,21 +463,110 @@ namespace casadi {
     for (auto&& m : call_.el) {
       g.add_dependency(m.f);
     }
+
+    // Generate the chunks of the algorithm as separate functions
+    casadi_int chunk_size = codegen_chunk_size(g);
+    if (chunk_size>0) {
+      std::string base = g.wrapper(self(), "sxchunk");
+      casadi_int n = algorithm_.size();
+      for (casadi_int c=0; c*chunk_size<n; ++c) {
+        casadi_int begin = c * chunk_size;
+        casadi_int end = std::min(begin + chunk_size, n);
+        std::string id = base + "_" + str(c);
+        std::string cname = g.shorthand(id);
+        // Calls refer to functions of the main compilation unit
+        bool has_call = false;
+        for (casadi_int k=begin; k<end; ++k) has_call = has_call || algorithm_[k].op==OP_CALL;
+        g.flush(g.body);
+        if (g.n_units()>1 && !has_call) {
+          g << signature(cname) << " {\n";
+          codegen_range(g, begin, end, true);
+          g << "return 0;\n";
+          g << "}\n\n";
+          std::stringstream def;
+          g.flush(def);
+          g.add_unit_function(id, def.str());
+          g << signature(cname) << ";\n\n";
+        } else {
+          g << "static " << signature(cname) << " {\n";
+          g.flush(g.body);
+          g.scope_enter();
+          codegen_range(g, begin, end, true);
+          g.scope_exit();
+          g << "return 0;\n";
+          g << "}\n\n";
+        }
+        g.flush(g.body);
+      }
+    }
+  }
+
+  casadi_int SXFunction::codegen_chunk_size(const CodeGenerator& g) const {
+    casadi_int n = algorithm_.size();
+    // Split large algorithms
+    if (g.chunk_size()>0 && n>g.chunk_size()) return g.chunk_size();
+    // Move the whole algorithm to a secondary compilation unit
+    if (g.n_units()>1 && call_.el.empty() && n>0) return n;
+    return 0;
   }
 
   void SXFunction::codegen_body(CodeGenerator& g) const {
     g.reserve_work(worksize_);
 
-    casadi_int k=0;
+    casadi_int chunk_size = codegen_chunk_size(g);
+    if (chunk_size>0) {
+      // Call the chunks in sequence
+      std::string base = g.wrapper(self(), "sxchunk");
+      casadi_int n = algorithm_.size();
+      for (casadi_int c=0; c*chunk_size<n; ++c) {
+        g << "if (" << g.shorthand(base + "_" + str(c)) << "(arg, res, iw, w, mem)) return 1;\n";
+      }
+    } else {
+      codegen_range(g, 0, algorithm_.size(), g.loop_rolling());
+    }
+  }
+
+  void SXFunction::codegen_range(CodeGenerator& g, casadi_int begin, casadi_int end,
+      bool indexed) const {
+    // Work vector elements: local variables or the work vector
+    auto work = [&](casadi_int i) {
+      return indexed ? "w[" + str(i) + "]" : g.sx_work(i);
+    };
+
+    // Instruction classes for loop rolling
+    std::vector<casadi_int> cl;
+    if (indexed && g.loop_rolling()) cl = codegen_loop_classes(begin, end);
+
     // Run the algorithm
-    for (auto&& a : algorithm_) {
+    for (casadi_int k=begin; k<end; ++k) {
+      if (!cl.empty()) {
+        // Longest stretch starting at k made up of repetitions of a block
+        casadi_int best_len = 0, best_rep = 0;
+        for (casadi_int len=1; len<=loop_max_block && k+2*len<=end; ++len) {
+          if (cl[k-begin]!=cl[k-begin+len]) continue;
+          // Length of the stretch with period len
+          casadi_int m = 0;
+          while (k+m+len<end && cl[k-begin+m]==cl[k-begin+m+len]) m++;
+          casadi_int n_rep = (m+len)/len;
+          if (n_rep*len>best_rep*best_len) {
+            best_len = len;
+            best_rep = n_rep;
+          }
+        }
+        if (best_rep>=2 && best_rep*best_len>=loop_min_instructions) {
+          codegen_loop(g, k, best_len, best_rep);
+          k += best_rep*best_len - 1;
+          continue;
+        }
+      }
+      const ScalarAtomic& a = algorithm_[k];
       if (a.op==OP_OUTPUT) {
         g << "if (res[" << a.i0 << "]!=0) "
-          << g.res(a.i0) << "[" << a.i2 << "]=" << g.sx_work(a.i1) << ";\n";
+          << g.res(a.i0) << "[" << a.i2 << "]=" << work(a.i1) << ";\n";
       } else if (a.op==OP_CALL) {
         const ExtendedAlgEl& m = call_.el[a.i1];
 
-        casadi_int worksize = g.avoid_stack() ? worksize_ : 0;
+        casadi_int worksize = g.avoid_stack() || indexed ? worksize_ : 0;
 
         // Collect input arguments
         casadi_int offset = worksize;
@@ -249,7 +598,7 @@ namespace casadi {
         for (casadi_int i=0; i<m.f_n_in; ++i) {
           if (m.copy_elision_arg[i]==-1) {
             for (casadi_int j=0; j<m.f_nnz_in[i]; ++j) {
-              g << "w["+str(k+worksize) + "] = " << g.sx_work(m.dep[k]) << ";\n";
+              g << "w["+str(k+worksize) + "] = " << work(m.dep[k]) << ";\n";
               k++;
             }
           } else {
@@ -262,19 +611,19 @@ namespace casadi {
         g << "if (" << flag << ") return 1;\n";
         for (casadi_int i=0;i<m.n_res;++i) {
           if (m.res[i]>=0) {
-            g << g.sx_work(m.res[i]) << " = ";
+            g << work(m.res[i]) << " = ";
             g << "w[" + str(i+out_offset) + "];\n";
           }
         }
       } else if (a.op==OP_INPUT) {
           if (!copy_elision_[k]) {
-            g << g.sx_work(a.i0) << "="
+            g << work(a.i0) << "="
               << g.arg(a.i1) << "? " << g.arg(a.i1) << "[" << a.i2 << "] : 0;\n";
           }
       } else {
 
         // Where to store the result
-        g << g.sx_work(a.i0) << "=";
+        g << work(a.i0) << "=";
 
         // What to store
         if (a.op==OP_CONST) {
@@ -282,15 +631,126 @@ namespace casadi {
         } else {
           casadi_int ndep = casadi_math<double>::ndeps(a.op);
           casadi_assert_dev(ndep>0);
-          if (ndep==1) g << g.print_op(a.op, g.sx_work(a.i1));
-          if (ndep==2) g << g.print_op(a.op, g.sx_work(a.i1), g.sx_work(a.i2));
+          if (ndep==1) g << g.print_op(a.op, work(a.i1));
+          if (ndep==2) g << g.print_op(a.op, work(a.i1), work(a.i2));
         }
         g  << ";\n";
       }
-      k++;
     }
   }
 
+  std::vector<casadi_int> SXFunction::codegen_loop_classes(casadi_int begin,
+      casadi_int end) const {
+    std::map<std::tuple<casadi_int, casadi_int, casadi_int>, casadi_int> classes;
+    std::vector<casadi_int> ret(end-begin);
+    for (casadi_int k=begin; k<end; ++k) {
+      const ScalarAtomic& a = algorithm_[k];
+      casadi_int c1 = 0, c2 = 0;
+      switch (a.op) {
+        case OP_INPUT: c1 = a.i1; c2 = copy_elision_[k]; break;
+        case OP_OUTPUT: c1 = a.i0; break;
+        case OP_CALL: c1 = k; break;
+        case OP_CONST:
+          // Non-finite constants cannot be tabulated
+          if (isnan(a.d)) {
+            c1 = 1;
+          } else if (isinf(a.d)) {
+            c1 = a.d>0 ? 2 : 3;
+          }
+          break;
+        default: break;
+      }
+      auto key = std::make_tuple(static_cast<casadi_int>(a.op), c1, c2);
+      auto it = classes.insert(std::make_pair(key, classes.size())).first;
+      ret[k-begin] = it->second;
+    }
+    return ret;
+  }
+
+  void SXFunction::codegen_loop(CodeGenerator& g, casadi_int begin, casadi_int len,
+      casadi_int n_rep) const {
+    // Index tables and loop body
+    std::stringstream decl, body;
+    casadi_int n_table = 0;
+    std::map<std::vector<casadi_int>, std::string> tables;
+
+    // Index expression for a field of the j-th instruction of the block
+    auto index = [&](casadi_int j, casadi_int field) -> std::string {
+      std::vector<casadi_int> v(n_rep);
+      for (casadi_int r=0; r<n_rep; ++r) {
+        const ScalarAtomic& a = algorithm_[begin + r*len + j];
+        v[r] = field==0 ? a.i0 : field==1 ? a.i1 : a.i2;
+      }
+      // Affine in the repetition?
+      casadi_int stride = v[1] - v[0];
+      bool affine = true;
+      for (casadi_int r=2; r<n_rep && affine; ++r) affine = v[r]-v[r-1]==stride;
+      if (!affine) {
+        // Tabulate, reusing identical tables
+        std::string& t = tables[v];
+        if (t.empty()) {
+          t = "t" + str(n_table++);
+          decl << CodeGenerator::array("static const casadi_int", t, n_rep, g.initializer(v));
+        }
+        return t + "[r]";
+      }
+      if (stride==0) return str(v[0]);
+      std::string ret = v[0]==0 ? "" : str(v[0]);
+      if (stride<0) {
+        ret += "-";
+      } else if (!ret.empty()) {
+        ret += "+";
+      }
+      if (std::abs(stride)!=1) ret += str(std::abs(stride)) + "*";
+      return ret + "r";
+    };
+    auto work = [&](casadi_int j, casadi_int field) {
+      return "w[" + index(j, field) + "]";
+    };
+
+    for (casadi_int j=0; j<len; ++j) {
+      const ScalarAtomic& a = algorithm_[begin + j];
+      if (a.op==OP_OUTPUT) {
+        body << "if (res[" << a.i0 << "]!=0) "
+             << g.res(a.i0) << "[" << index(j, 2) << "]=" << work(j, 1) << ";\n";
+      } else if (a.op==OP_INPUT) {
+        if (!copy_elision_[begin + j]) {
+          body << work(j, 0) << "="
+               << g.arg(a.i1) << "? " << g.arg(a.i1) << "[" << index(j, 2) << "] : 0;\n";
+        }
+      } else {
+        body << work(j, 0) << "=";
+        if (a.op==OP_CONST) {
+          std::vector<double> v(n_rep);
+          for (casadi_int r=0; r<n_rep; ++r) v[r] = algorithm_[begin + r*len + j].d;
+          if (std::all_of(v.begin(), v.end(), [&](double d) { return d==v[0];})
+              || isnan(v[0])) {
+            body << g.constant(v[0]);
+          } else {
+            std::string t = "t" + str(n_table++);
+            decl << CodeGenerator::array("static const casadi_real", t, n_rep, g.initializer(v));
+            body << t << "[r]";
+          }
+        } else {
+          casadi_int ndep = casadi_math<double>::ndeps(a.op);
+          casadi_assert_dev(ndep>0);
+          if (ndep==1) body << g.print_op(a.op, work(j, 1));
+          if (ndep==2) body << g.print_op(a.op, work(j, 1), work(j, 2));
+        }
+        body << ";\n";
+      }
+    }
+
+    // Loop over the repetitions
+    g << "{\n";
+    g << "casadi_int r;\n";
+    g << decl.str();
+    g << "for (r=0; r<" << n_rep << "; ++r) {\n";
+    g << body.str();
+    g << "}\n";
+    g << "}\n";
+  }
+
   const Options SXFunction::options_
   = {{&FunctionInternal::options_},
      {{"default_in",
@@ -298,14 +758,27 @@ namespace casadi {
         "Default input values"}},
       {"just_in_time_sparsity",
        {OT_BOOL,
-        "Propagate sparsity patterns using just-in-time "
-        "compilation to a CPU or GPU using OpenCL"}},
+        "Calculate Jacobian sparsity patterns using wide sparsity propagation: "
+        "sparsity_directions directions per sweep, sweeps distributed over threads. "
+        "Not available with call nodes (Default: false)"}},
+      {"sparsity_directions",
+       {OT_INT,
+        "Number of directions per sweep with just_in_time_sparsity: 64, 128, 256 or 512 "
+        "(Default: 256)"}},
+      {"sparsity_threads",
+       {OT_INT,
+        "Maximum number of threads of the global thread pool used with just_in_time_sparsity, "
+        "0 for all (Default: 0)"}},
       {"just_in_time_opencl",
        {OT_BOOL,
         "Just-in-time compilation for numeric evaluation using OpenCL (experimental)"}},
       {"live_variables",
        {OT_BOOL,
         "Reuse variables in the work vector"}},
+      {"profile_instructions",
+       {OT_BOOL,
+        "Accumulate number of calls and wall time per instruction during numerical "
+        "evaluation, see Function::print_profile and Function::save_profile (Default: false)"}},
       {"cse",
        {OT_BOOL,
         "Perform common subexpression elimination (complexity is N*log(N) in graph size)"}},
@@ -314,7 +787,17 @@ namespace casadi {
         "Allow construction with free variables (Default: false)"}},
       {"allow_duplicate_io_names",
        {OT_BOOL,
-        "Allow construction with duplicate io names (Default: false)"}}
+        "Allow construction with duplicate io names (Default: false)"}},
+      {"bytecode",
+       {OT_BOOL,
+        "Evaluate numerically using a compact bytecode with direct threaded dispatch "
+        "(computed goto, where supported by the compiler) instead of the "
+        "instruction-by-instruction interpreter (Default: false)"}},
+      {"native_jit",
+       {OT_BOOL,
+        "Evaluate numerically using machine code generated in memory, without an external "
+        "compiler. Currently x86-64 Linux only, falls back to interpreted evaluation "
+        "otherwise or if the function contains call nodes (Default: false)"}}
      }
   };
 
@@ -323,7 +806,12 @@ namespace casadi {
     //opts["default_in"] = default_in_;
     opts["live_variables"] = live_variables_;
     opts["just_in_time_sparsity"] = just_in_time_sparsity_;
+    opts["sparsity_directions"] = sparsity_directions_;
+    opts["sparsity_threads"] = sparsity_threads_;
     opts["just_in_time_opencl"] = just_in_time_opencl_;
+    opts["bytecode"] = bytecode_;
+    opts["native_jit"] = native_jit_;
+    opts["profile_instructions"] = profile_instructions_;
     return opts;
   }
 
@@ -348,10 +836,18 @@ namespace casadi {
         just_in_time_opencl_ = op.second;
       } else if (op.first=="just_in_time_sparsity") {
         just_in_time_sparsity_ = op.second;
+      } else if (op.first=="sparsity_directions") {
+        sparsity_directions_ = op.second;
+      } else if (op.first=="sparsity_threads") {
+        sparsity_threads_ = op.second;
       } else if (op.first=="cse") {
         cse_opt = op.second;
       } else if (op.first=="allow_free") {
         allow_free = op.second;
+      } else if (op.first=="bytecode") {
+        bytecode_ = op.second;
+      } else if (op.first=="native_jit") {
+        native_jit_ = op.second;
       }
     }
 
@@ -675,14 +1171,24 @@ namespace casadi {
 
     init_copy_elision();
 
+    init_bytecode();
+
+    init_native_jit();
+
     // Initialize just-in-time compilation for numeric evaluation using OpenCL
     if (just_in_time_opencl_) {
       casadi_error("OpenCL is not supported in this version of CasADi");
     }
 
-    // Initialize just-in-time compilation for sparsity propagation using OpenCL
-    if (just_in_time_sparsity_) {
-      casadi_error("OpenCL is not supported in this version of CasADi");
+    // Wide sparsity propagation
+    casadi_assert(sparsity_directions_==64 || sparsity_directions_==128
+      || sparsity_directions_==256 || sparsity_directions_==512,
+      "Option 'sparsity_directions' must be 64, 128, 256 or 512, got "
+      + str(sparsity_directions_));
+    casadi_assert(sparsity_threads_>=0, "Option 'sparsity_threads' must be nonnegative");
+    if (just_in_time_sparsity_ && !call_.el.empty()) {
+      casadi_warning(name_ + ": Option 'just_in_time_sparsity' is not supported "
+                     "with call nodes, ignored.");
     }
 
     // Print
@@ -1558,6 +2064,123 @@ namespace casadi {
     return 0;
   }
 
+  /// \cond INTERNAL
+  // Forward sparsity propagation with N words per nonzero
+  template<casadi_int N>
+  void sp_forward_wide_alg(const std::vector<ScalarAtomic>& algorithm,
+                           const bvec_t** arg, bvec_t** res, bvec_t* w) {
+    for (auto&& e : algorithm) {
+      bvec_t* f = w + e.i0*N;
+      switch (e.op) {
+      case OP_CONST:
+      case OP_PARAMETER:
+        for (casadi_int k=0; k<N; ++k) f[k] = 0;
+        break;
+      case OP_INPUT:
+        if (arg[e.i1]==nullptr) {
+          for (casadi_int k=0; k<N; ++k) f[k] = 0;
+        } else {
+          const bvec_t* a = arg[e.i1] + e.i2*N;
+          for (casadi_int k=0; k<N; ++k) f[k] = a[k];
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[e.i0]!=nullptr) {
+          bvec_t* r = res[e.i0] + e.i2*N;
+          const bvec_t* x = w + e.i1*N;
+          for (casadi_int k=0; k<N; ++k) r[k] = x[k];
+        }
+        break;
+      default: // Unary or binary operation
+        {
+          const bvec_t* x = w + e.i1*N;
+          const bvec_t* y = w + e.i2*N;
+          for (casadi_int k=0; k<N; ++k) f[k] = x[k] | y[k];
+        }
+      }
+    }
+  }
+
+  // Reverse sparsity propagation with N words per nonzero
+  template<casadi_int N>
+  void sp_reverse_wide_alg(const std::vector<ScalarAtomic>& algorithm,
+                           bvec_t** arg, bvec_t** res, bvec_t* w) {
+    for (auto it=algorithm.rbegin(); it!=algorithm.rend(); ++it) {
+      bvec_t* f = w + it->i0*N;
+      switch (it->op) {
+      case OP_CONST:
+      case OP_PARAMETER:
+        for (casadi_int k=0; k<N; ++k) f[k] = 0;
+        break;
+      case OP_INPUT:
+        if (arg[it->i1]!=nullptr) {
+          bvec_t* a = arg[it->i1] + it->i2*N;
+          for (casadi_int k=0; k<N; ++k) a[k] |= f[k];
+        }
+        for (casadi_int k=0; k<N; ++k) f[k] = 0;
+        break;
+      case OP_OUTPUT:
+        if (res[it->i0]!=nullptr) {
+          bvec_t* r = res[it->i0] + it->i2*N;
+          bvec_t* x = w + it->i1*N;
+          for (casadi_int k=0; k<N; ++k) {
+            x[k] |= r[k];
+            r[k] = 0;
+          }
+        }
+        break;
+      default: // Unary or binary operation
+        {
+          bvec_t seed[N];
+          for (casadi_int k=0; k<N; ++k) {
+            seed[k] = f[k];
+            f[k] = 0;
+          }
+          bvec_t* x = w + it->i1*N;
+          for (casadi_int k=0; k<N; ++k) x[k] |= seed[k];
+          bvec_t* y = w + it->i2*N;
+          for (casadi_int k=0; k<N; ++k) y[k] |= seed[k];
+        }
+      }
+    }
+  }
+  /// \endcond
+
+  casadi_int SXFunction::sp_wide_words() const {
+    if (!just_in_time_sparsity_ || !call_.el.empty()) return 0;
+    return sparsity_directions_ / bvec_size;
+  }
+
+  casadi_int SXFunction::sp_wide_threads() const {
+    return sparsity_threads_==0 ? ThreadPool::global().size() : sparsity_threads_;
+  }
+
+  int SXFunction::sp_forward_wide(const bvec_t** arg, bvec_t** res, bvec_t* w,
+      casadi_int n_word) const {
+    // Fixed width inner loops, vectorized by the compiler
+    switch (n_word) {
+    case 1: sp_forward_wide_alg<1>(algorithm_, arg, res, w); break;
+    case 2: sp_forward_wide_alg<2>(algorithm_, arg, res, w); break;
+    case 4: sp_forward_wide_alg<4>(algorithm_, arg, res, w); break;
+    case 8: sp_forward_wide_alg<8>(algorithm_, arg, res, w); break;
+    default: casadi_error("Unsupported width: " + str(n_word));
+    }
+    return 0;
+  }
+
+  int SXFunction::sp_reverse_wide(bvec_t** arg, bvec_t** res, bvec_t* w,
+      casadi_int n_word) const {
+    std::fill_n(w, sz_w_sp_wide(n_word), 0);
+    switch (n_word) {
+    case 1: sp_reverse_wide_alg<1>(algorithm_, arg, res, w); break;
+    case 2: sp_reverse_wide_alg<2>(algorithm_, arg, res, w); break;
+    case 4: sp_reverse_wide_alg<4>(algorithm_, arg, res, w); break;
+    case 8: sp_reverse_wide_alg<8>(algorithm_, arg, res, w); break;
+    default: casadi_error("Unsupported width: " + str(n_word));
+    }
+    return 0;
+  }
+
   const SX SXFunction::sx_in(casadi_int ind) const {
     return in_.at(ind);
   }
@@ -1673,7 +2296,7 @@ namespace casadi {
 
   SXFunction::SXFunction(DeserializingStream& s) :
     XFunction<SXFunction, SX, SXNode>(s) {
-    int version = s.version("SXFunction", 1, 2);
+    int version = s.version("SXFunction", 1, 7);
     size_t n_instructions;
     s.unpack("SXFunction::n_instr", n_instructions);
 
@@ -1722,26 +2345,59 @@ namespace casadi {
     }
 
     algorithm_.resize(n_instructions);
-    for (casadi_int k=0;k<n_instructions;++k) {
-      AlgEl& e = algorithm_[k];
-      s.unpack("SXFunction::ScalarAtomic::op", e.op);
-      s.unpack("SXFunction::ScalarAtomic::i0", e.i0);
-      s.unpack("SXFunction::ScalarAtomic::i1", e.i1);
-      s.unpack("SXFunction::ScalarAtomic::i2", e.i2);
+    if (version>=6) {
+      std::vector<int> alg;
+      s.unpack("SXFunction::algorithm", alg);
+      casadi_assert(alg.size()==4*n_instructions, "Corrupt SXFunction::algorithm");
+      for (casadi_int k=0;k<n_instructions;++k) {
+        AlgEl& e = algorithm_[k];
+        e.op = alg[4*k];
+        e.i0 = alg[4*k+1];
+        e.i1 = alg[4*k+2];
+        e.i2 = alg[4*k+3];
+      }
+    } else {
+      for (casadi_int k=0;k<n_instructions;++k) {
+        AlgEl& e = algorithm_[k];
+        s.unpack("SXFunction::ScalarAtomic::op", e.op);
+        s.unpack("SXFunction::ScalarAtomic::i0", e.i0);
+        s.unpack("SXFunction::ScalarAtomic::i1", e.i1);
+        s.unpack("SXFunction::ScalarAtomic::i2", e.i2);
+      }
     }
 
     // Default (persistent) options
     just_in_time_opencl_ = false;
     just_in_time_sparsity_ = false;
+    sparsity_directions_ = 256;
+    sparsity_threads_ = 0;
 
     s.unpack("SXFunction::live_variables", live_variables_);
 
+    bytecode_ = false;
+    if (version>=3) s.unpack("SXFunction::bytecode", bytecode_);
+
+    native_jit_ = false;
+    native_ = nullptr;
+    if (version>=4) s.unpack("SXFunction::native_jit", native_jit_);
+
+    if (version>=5) {
+      s.unpack("SXFunction::just_in_time_sparsity", just_in_time_sparsity_);
+      s.unpack("SXFunction::sparsity_directions", sparsity_directions_);
+      s.unpack("SXFunction::sparsity_threads", sparsity_threads_);
+    }
+
+    if (version>=7) s.unpack("SXFunction::profile_instructions", profile_instructions_);
+
     XFunction<SXFunction, SX, SXNode>::delayed_deserialize_members(s);
+
+    init_bytecode();
+    init_native_jit();
   }
 
   void SXFunction::serialize_body(SerializingStream &s) const {
     XFunction<SXFunction, SX, SXNode>::serialize_body(s);
-    s.version("SXFunction", 2);
+    s.version("SXFunction", 7);
     s.pack("SXFunction::n_instr", algorithm_.size());
 
     s.pack("SXFunction::worksize", worksize_);
@@ -1769,16 +2425,26 @@ namespace casadi {
 
     s.pack("SXFunction::copy_elision", copy_elision_);
 
-    // Loop over algorithm
+    // Algorithm as a flat vector, allowing bulk I/O
+    std::vector<int> alg;
+    alg.reserve(4*algorithm_.size());
     for (const auto& e : algorithm_) {
-      s.pack("SXFunction::ScalarAtomic::op", e.op);
-      s.pack("SXFunction::ScalarAtomic::i0", e.i0);
-      s.pack("SXFunction::ScalarAtomic::i1", e.i1);
-      s.pack("SXFunction::ScalarAtomic::i2", e.i2);
+      alg.push_back(e.op);
+      alg.push_back(e.i0);
+      alg.push_back(e.i1);
+      alg.push_back(e.i2);
     }
+    s.pack("SXFunction::algorithm", alg);
 
     s.pack("SXFunction::live_variables", live_variables_);
 
+    s.pack("SXFunction::bytecode", bytecode_);
+    s.pack("SXFunction::native_jit", native_jit_);
+    s.pack("SXFunction::just_in_time_sparsity", just_in_time_sparsity_);
+    s.pack("SXFunction::sparsity_directions", sparsity_directions_);
+    s.pack("SXFunction::sparsity_threads", sparsity_threads_);
+    s.pack("SXFunction::profile_instructions", profile_instructions_);
+
     XFunction<SXFunction, SX, SXNode>::delayed_serialize_members(s);
   }
 
@@ -27,6 +27,7 @@
 #define CASADI_SX_FUNCTION_HPP
 
 #include "x_function.hpp"
+#include "native_jit.hpp"
 
 /// \cond INTERNAL
 
@@ -43,6 +44,16 @@ namespace casadi {
     };
   };
 
+/// Scalar operations with a fixed numerical implementation, cf. CASADI_MATH_FUN_BUILTIN
+#define CASADI_SX_BYTECODE_BUILTIN(X) \
+  X(OP_ASSIGN) X(OP_ADD) X(OP_SUB) X(OP_MUL) X(OP_DIV) X(OP_NEG) X(OP_EXP) X(OP_LOG) \
+  X(OP_POW) X(OP_CONSTPOW) X(OP_SQRT) X(OP_SQ) X(OP_TWICE) X(OP_SIN) X(OP_COS) X(OP_TAN) \
+  X(OP_ASIN) X(OP_ACOS) X(OP_ATAN) X(OP_LT) X(OP_LE) X(OP_EQ) X(OP_NE) X(OP_NOT) X(OP_AND) \
+  X(OP_OR) X(OP_IF_ELSE_ZERO) X(OP_FLOOR) X(OP_CEIL) X(OP_FMOD) X(OP_REMAINDER) X(OP_FABS) \
+  X(OP_SIGN) X(OP_COPYSIGN) X(OP_ERF) X(OP_FMIN) X(OP_FMAX) X(OP_INV) X(OP_SINH) X(OP_COSH) \
+  X(OP_TANH) X(OP_ASINH) X(OP_ACOSH) X(OP_ATANH) X(OP_ATAN2) X(OP_ERFINV) X(OP_LIFT) \
+  X(OP_PRINTME) X(OP_LOG1P) X(OP_EXPM1) X(OP_HYPOT)
+
 /** \brief  Internal node class for SXFunction
 
     Do not use any internal class directly - always use the public Function
@@ -325,6 +336,26 @@ class CASADI_EXPORT SXFunction :
       \identifier{v5} */
   void codegen_body(CodeGenerator& g) const override;
 
+  /** \brief Number of instructions per generated chunk, 0 if not chunked
+
+      Chunks are separate C functions sharing the work vector. Without calls, the
+      whole algorithm forms a chunk that can be moved to a secondary compilation unit. */
+  casadi_int codegen_chunk_size(const CodeGenerator& g) const;
+
+  /** \brief Generate code for the instructions [begin, end) of the algorithm
+
+      If indexed, work vector elements are stored in w rather than in local variables */
+  void codegen_range(CodeGenerator& g, casadi_int begin, casadi_int end, bool indexed) const;
+
+  /** \brief Classify the instructions [begin, end) for loop rolling
+
+      Instructions with the same class differ at most in their work vector indices,
+      nonzero indices and finite constants. Calls get a unique class. */
+  std::vector<casadi_int> codegen_loop_classes(casadi_int begin, casadi_int end) const;
+
+  /** \brief Generate code for n_rep repetitions of the block [begin, begin+len) as a loop */
+  void codegen_loop(CodeGenerator& g, casadi_int begin, casadi_int len, casadi_int n_rep) const;
+
   /** \brief  Propagate sparsity forward
 
       \identifier{v6} */
@@ -336,6 +367,22 @@ class CASADI_EXPORT SXFunction :
       \identifier{v7} */
   int sp_reverse(bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w, void* mem) const override;
 
+  /** \brief Number of bvec_t words per nonzero for wide sparsity propagation */
+  casadi_int sp_wide_words() const override;
+
+  /** \brief Maximum number of threads for wide sparsity propagation */
+  casadi_int sp_wide_threads() const override;
+
+  /** \brief Work vector size (in bvec_t) for wide sparsity propagation */
+  size_t sz_w_sp_wide(casadi_int n_word) const override { return worksize_ * n_word;}
+
+  /** \brief Propagate sparsity forward, n_word words per nonzero */
+  int sp_forward_wide(const bvec_t** arg, bvec_t** res, bvec_t* w,
+                      casadi_int n_word) const override;
+
+  /** \brief Propagate sparsity backwards, n_word words per nonzero */
+  int sp_reverse_wide(bvec_t** arg, bvec_t** res, bvec_t* w, casadi_int n_word) const override;
+
   /** *\brief get SX expression associated with instructions
 
        \identifier{v8} */
@@ -358,12 +405,64 @@ class CASADI_EXPORT SXFunction :
   /// With just-in-time compilation using OpenCL
   bool just_in_time_opencl_;
 
-  /// With just-in-time compilation for the sparsity propagation
+  /// Wide (multi-word, multithreaded) sparsity propagation
   bool just_in_time_sparsity_;
 
+  /// Directions per sweep with wide sparsity propagation
+  casadi_int sparsity_directions_;
+
+  /// Maximum number of threads for wide sparsity propagation, 0 for the thread pool size
+  casadi_int sparsity_threads_;
+
   /// Live variables?
   bool live_variables_;
 
+  /// Evaluate numerically using the compact bytecode
+  bool bytecode_;
+
+  ///@{
+  /** \brief Compact bytecode for numerical evaluation
+
+      Opcodes and (32-bit) operands are stored in separate streams,
+      constants in a separate pool. Generated from algorithm_. */
+  std::vector<unsigned char> bc_op_;
+  std::vector<int> bc_arg_;
+  std::vector<double> bc_const_;
+  ///@}
+
+  /** \brief Part of initialize responsible for generating the bytecode */
+  void init_bytecode();
+
+  /** \brief Instruction types and descriptions for the instruction profile */
+  void instruction_labels(std::vector<std::string>& type, std::vector<std::string>& descr) const;
+
+  /** \brief Evaluate numerically using the bytecode */
+  int eval_bytecode(const double** arg, double** res, casadi_int* iw, double* w) const;
+
+  /// Evaluate numerically using in-process generated machine code
+  bool native_jit_;
+
+  /// Generated machine code, if any
+  NativeJit* native_;
+
+  /** \brief Part of initialize responsible for generating machine code */
+  void init_native_jit();
+
+  /** \brief Evaluate numerically at a batch of points in one pass over the algorithm
+
+      Each work vector slot holds n_lane consecutive doubles, one per point, so that
+      every instruction is applied to all lanes in a (vectorizable) loop.
+      The data of input/output i for lane l is found at offset l*nnz_in(i)/l*nnz_out(i).
+      Requires a work vector of size sz_w_lanes(n_lane). Not available with call nodes.
+  */
+  int eval_lanes(const double** arg, double** res, double* w, casadi_int n_lane) const;
+
+  /** \brief Work vector size for eval_lanes */
+  size_t sz_w_lanes(casadi_int n_lane) const { return worksize_ * n_lane;}
+
+  /** \brief Can the function be evaluated with eval_lanes? */
+  bool has_eval_lanes() const { return call_.el.empty() && free_vars_.empty();}
+
 protected:
   template<typename T>
   void call_fwd(const AlgEl& e, const T** arg, T** res, casadi_int* iw, T* w) const;
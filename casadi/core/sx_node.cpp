@@ -34,12 +34,15 @@
 
 #include <limits>
 #include <stack>
+#include <unordered_map>
 
 namespace casadi {
 
   SXNode::SXNode() {
     count = 0;
     temp = 0;
+    pool_class_ = 0;
+    hash_consed_ = false;
   }
 
   SXNode::~SXNode() {
@@ -186,9 +189,11 @@ namespace casadi {
     if (n->count>0) return;
     // Delete straight away if it doesn't have any dependencies
     if (!n->n_dep()) {
-      delete n;
+      destroy(n);
       return;
     }
+    // Dependencies are detached below, before the destructor runs
+    if (n->hash_consed_) n->hash_cons_release();
     // Stack of expressions to be deleted
     std::stack<SXNode*> deletion_stack;
     // Add the node to the deletion stack
@@ -208,9 +213,10 @@ namespace casadi {
           // Check if unary or binary
           if (!n2->n_dep()) {
             // Delete straight away if not binary
-            delete n2;
+            destroy(n2);
           } else {
             // Add to deletion stack
+            if (n2->hash_consed_) n2->hash_cons_release();
             deletion_stack.push(n2);
             added_to_stack = true;
           }
@@ -218,12 +224,111 @@ namespace casadi {
       }
       // Delete and pop from stack if nothing added to the stack
       if (!added_to_stack) {
-        delete deletion_stack.top();
+        destroy(deletion_stack.top());
         deletion_stack.pop();
       }
     }
   }
 
+  void SXNode::destroy(SXNode* n) {
+    unsigned char c = n->pool_class_;
+    if (c==0) {
+      delete n;
+    } else {
+      n->~SXNode();
+      SXNodePool::deallocate(n, c);
+    }
+  }
+
+  namespace {
+    // Key of an operation node in the hash-consing table
+    struct HashConsKey {
+      unsigned char op;
+      const SXNode* dep0;
+      const SXNode* dep1;
+      bool operator==(const HashConsKey& k) const {
+        return op==k.op && dep0==k.dep0 && dep1==k.dep1;
+      }
+    };
+
+    struct HashConsKeyHash {
+      size_t operator()(const HashConsKey& k) const {
+        size_t r = std::hash<const SXNode*>()(k.dep0);
+        r ^= std::hash<const SXNode*>()(k.dep1) + 0x9e3779b9 + (r << 6) + (r >> 2);
+        r ^= k.op + 0x9e3779b9 + (r << 6) + (r >> 2);
+        return r;
+      }
+    };
+
+    HashConsKey hash_cons_key(unsigned char op, const SXNode* dep0, const SXNode* dep1) {
+      if (dep1 && dep1 < dep0 && operation_checker<CommChecker>(op)) std::swap(dep0, dep1);
+      return {op, dep0, dep1};
+    }
+
+    struct HashConsTable {
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+      std::mutex mtx;
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
+      std::unordered_map<HashConsKey, SXNode*, HashConsKeyHash> nodes;
+    };
+
+    // Never destroyed: nodes may still be released during static destruction
+    HashConsTable& hash_cons_table() {
+      static HashConsTable* t = new HashConsTable();
+      return *t;
+    }
+  } // namespace
+
+  SXElem SXNode::hash_cons(unsigned char op, const SXElem& dep0, const SXElem* dep1) {
+    HashConsKey key = hash_cons_key(op, dep0.get(), dep1 ? dep1->get() : nullptr);
+    HashConsTable& t = hash_cons_table();
+    SXNode* n = nullptr;
+    {
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+      std::lock_guard<std::mutex> lock(t.mtx);
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
+      auto it = t.nodes.find(key);
+      if (it!=t.nodes.end()) {
+        // Take a reference, unless the node is already being destroyed
+        n = it->second;
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+        unsigned int c = n->count.load();
+        while (c!=0 && !n->count.compare_exchange_weak(c, c+1)) {}
+#else // CASADI_WITH_THREADSAFE_SYMBOLICS
+        unsigned int c = n->count;
+        if (c!=0) n->count++;
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
+        if (c==0) n = nullptr;
+      }
+      if (n==nullptr) {
+        if (dep1) {
+          n = alloc<BinarySX>(op, dep0, *dep1);
+        } else {
+          n = alloc<UnarySX>(op, dep0);
+        }
+        n->hash_consed_ = true;
+        n->count++;
+        t.nodes[key] = n;
+      }
+    }
+    // Hand over the reference taken above
+    SXElem ret = SXElem::create(n);
+    n->count--;
+    return ret;
+  }
+
+  void SXNode::hash_cons_release() {
+    hash_consed_ = false;
+    HashConsKey key = hash_cons_key(op(), dep(0).get(), n_dep()==2 ? dep(1).get() : nullptr);
+    HashConsTable& t = hash_cons_table();
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+    std::lock_guard<std::mutex> lock(t.mtx);
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
+    auto it = t.nodes.find(key);
+    // The entry may already have been replaced by a new node
+    if (it!=t.nodes.end() && it->second==this) t.nodes.erase(it);
+  }
+
   SXElem SXNode::get_output(casadi_int oind) const {
     casadi_assert(oind==0, "Output index out of bounds");
     return shared_from_this();
@@ -35,6 +35,8 @@
 
     \identifier{9s} */
 #include "sx_elem.hpp"
+#include "sx_node_pool.hpp"
+#include "global_options.hpp"
 
 
 /// \cond INTERNAL
@@ -175,6 +177,35 @@ namespace casadi {
         \identifier{a9} */
     static void safe_delete(SXNode* n);
 
+    /** \brief Create a node, taking its storage from the node pool if enabled
+
+        Used for the node types of fixed size that make up the bulk of a graph */
+    template<typename T, typename... Args>
+    static T* alloc(Args&&... args) {
+      unsigned char c = SXNodePool::size_class(sizeof(T));
+      if (!GlobalOptions::sx_node_pool || c==0) return new T(std::forward<Args>(args)...);
+      T* n = new (SXNodePool::allocate(c)) T(std::forward<Args>(args)...);
+      n->pool_class_ = c;
+      return n;
+    }
+
+    /** \brief Destroy a node and release its storage
+
+        Every node that is no longer referenced must be released with this function */
+    static void destroy(SXNode* n);
+
+    /** \brief Get a shared operation node from the hash-consing table, or create it
+
+        Structurally identical operation nodes are shared: the table is keyed by the
+        operation and the dependency nodes, with commutative operands ordered.
+        Binary if dep1 is not null, unary otherwise. */
+    static SXElem hash_cons(unsigned char op, const SXElem& dep0, const SXElem* dep1);
+
+    /** \brief Remove the node from the hash-consing table
+
+        Must be called while the dependencies are still attached */
+    void hash_cons_release();
+
     // Depth when checking equalities
     static casadi_int eq_depth_;
 
@@ -197,6 +228,12 @@ namespace casadi {
     unsigned int count;
 #endif // CASADI_WITH_THREADSAFE_SYMBOLICS
 
+    /// Size class of the pool block holding the node, 0 if allocated with new
+    unsigned char pool_class_;
+
+    /// Node is registered in the hash-consing table
+    bool hash_consed_;
+
     /** \brief Serialize an object
 
         \identifier{aa} */
@@ -0,0 +1,199 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "sx_node_pool.hpp"
+
+#include <new>
+#include <vector>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
+namespace casadi {
+
+  namespace {
+
+    // Unused block, linked into a free list
+    struct FreeBlock {
+      FreeBlock* next;
+    };
+
+    // Number of size classes, class 0 is unused
+    const size_t n_class = SXNodePool::max_size / 8 + 1;
+
+    // Size of a slab in bytes
+    const size_t slab_size = 1 << 16;
+
+    // Number of blocks moved between a thread and the shared free list at a time
+    const size_t batch_size = 256;
+
+    // Blocks shared by all threads
+    struct SharedPool {
+#ifdef CASADI_WITH_THREAD
+      std::mutex mtx;
+#endif // CASADI_WITH_THREAD
+      FreeBlock* head[n_class] = {};
+      std::vector<char*> slabs;
+      size_t reserved = 0;
+    };
+
+#ifdef CASADI_WITH_THREAD
+#define CASADI_POOL_LOCK std::lock_guard<std::mutex> lock(sp.mtx);
+#else // CASADI_WITH_THREAD
+#define CASADI_POOL_LOCK
+#endif // CASADI_WITH_THREAD
+
+    // Never destroyed: nodes may still be released during static destruction
+    SharedPool& shared_pool() {
+      static SharedPool* sp = new SharedPool();
+      return *sp;
+    }
+
+    // Free lists of the current thread, trivially destructible so that they
+    // remain accessible after the thread has started shutting down
+    struct LocalPool {
+      FreeBlock* head[n_class];
+      size_t count[n_class];
+      // Thread exit handler registered
+      bool registered;
+      // Thread is exiting, bypass the local free lists
+      bool detached;
+    };
+    thread_local LocalPool local_pool;
+
+    // Hands the free lists of an exiting thread back to the shared pool
+    struct LocalPoolRelease {
+      ~LocalPoolRelease() {
+        LocalPool& lp = local_pool;
+        SharedPool& sp = shared_pool();
+        CASADI_POOL_LOCK
+        for (size_t c = 1; c < n_class; ++c) {
+          while (lp.head[c]) {
+            FreeBlock* b = lp.head[c];
+            lp.head[c] = b->next;
+            b->next = sp.head[c];
+            sp.head[c] = b;
+          }
+          lp.count[c] = 0;
+        }
+        lp.detached = true;
+      }
+    };
+
+    void register_local_pool(LocalPool& lp) {
+      static thread_local LocalPoolRelease release;
+      (void)release;
+      lp.registered = true;
+    }
+
+    // Take a block from the shared pool, carving a new slab if needed
+    // Must be called with the lock held
+    FreeBlock* shared_pop(SharedPool& sp, unsigned char c) {
+      if (!sp.head[c]) {
+        size_t sz = 8 * c;
+        char* slab = static_cast<char*>(::operator new(slab_size));
+        sp.slabs.push_back(slab);
+        sp.reserved += slab_size;
+        for (size_t k = 0; k + sz <= slab_size; k += sz) {
+          FreeBlock* b = reinterpret_cast<FreeBlock*>(slab + k);
+          b->next = sp.head[c];
+          sp.head[c] = b;
+        }
+      }
+      FreeBlock* b = sp.head[c];
+      sp.head[c] = b->next;
+      return b;
+    }
+
+  } // namespace
+
+  void* SXNodePool::allocate(unsigned char c) {
+    LocalPool& lp = local_pool;
+    if (lp.head[c]) {
+      // Fast path: pop from the local free list
+      FreeBlock* b = lp.head[c];
+      lp.head[c] = b->next;
+      lp.count[c]--;
+      return b;
+    }
+    SharedPool& sp = shared_pool();
+    if (lp.detached) {
+      CASADI_POOL_LOCK
+      return shared_pop(sp, c);
+    }
+    if (!lp.registered) register_local_pool(lp);
+    // Refill the local free list with a batch from the shared pool
+    CASADI_POOL_LOCK
+    for (size_t k = 0; k < batch_size; ++k) {
+      FreeBlock* b = shared_pop(sp, c);
+      b->next = lp.head[c];
+      lp.head[c] = b;
+    }
+    lp.count[c] = batch_size - 1;
+    FreeBlock* b = lp.head[c];
+    lp.head[c] = b->next;
+    return b;
+  }
+
+  void SXNodePool::deallocate(void* p, unsigned char c) {
+    FreeBlock* b = static_cast<FreeBlock*>(p);
+    LocalPool& lp = local_pool;
+    if (lp.detached) {
+      SharedPool& sp = shared_pool();
+      CASADI_POOL_LOCK
+      b->next = sp.head[c];
+      sp.head[c] = b;
+      return;
+    }
+    if (!lp.registered) register_local_pool(lp);
+    // Fast path: push to the local free list
+    b->next = lp.head[c];
+    lp.head[c] = b;
+    if (++lp.count[c] < 2 * batch_size) return;
+    // Too many blocks retained by this thread, return a batch to the shared pool
+    SharedPool& sp = shared_pool();
+    CASADI_POOL_LOCK
+    for (size_t k = 0; k < batch_size; ++k) {
+      b = lp.head[c];
+      lp.head[c] = b->next;
+      b->next = sp.head[c];
+      sp.head[c] = b;
+    }
+    lp.count[c] -= batch_size;
+  }
+
+  size_t SXNodePool::reserved() {
+    SharedPool& sp = shared_pool();
+    CASADI_POOL_LOCK
+    return sp.reserved;
+  }
+
+} // namespace casadi
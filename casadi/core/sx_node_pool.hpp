@@ -0,0 +1,74 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_SX_NODE_POOL_HPP
+#define CASADI_SX_NODE_POOL_HPP
+
+#include "casadi_common.hpp"
+
+#include <cstddef>
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Slab allocator for fixed-size expression graph nodes
+
+      Blocks are carved out of large slabs and recycled through per-thread free lists,
+      one per size class (multiples of 8 bytes up to max_size), so that allocating and
+      releasing a node usually amounts to popping or pushing a singly linked list without
+      synchronization. Blocks move between the threads and a shared free list in batches.
+      The free lists of an exiting thread are handed back to the shared list. Slabs are
+      retained for the lifetime of the process.
+
+      Whether new nodes are taken from the pool is controlled by
+      GlobalOptions::setSXNodePool.
+  */
+  class CASADI_EXPORT SXNodePool {
+  public:
+    /// Largest block served by the pool
+    static const size_t max_size = 64;
+
+    /// Size class of a block of sz bytes, 0 if it is too large to be pooled
+    static unsigned char size_class(size_t sz) {
+      return sz <= max_size ? static_cast<unsigned char>((sz + 7) / 8) : 0;
+    }
+
+    /// Take a block of size class c
+    static void* allocate(unsigned char c);
+
+    /// Return a block of size class c
+    static void deallocate(void* p, unsigned char c);
+
+    /// Number of bytes held in slabs
+    static size_t reserved();
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_SX_NODE_POOL_HPP
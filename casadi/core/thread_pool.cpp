@@ -0,0 +1,178 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "thread_pool.hpp"
+#include "global_options.hpp"
+#include "exception.hpp"
+
+#include <algorithm>
+
+#if defined(CASADI_WITH_THREAD) && !defined(CASADI_WITH_THREAD_MINGW) && defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#define CASADI_THREAD_POOL_PINNING
+#endif
+
+namespace casadi {
+
+  struct ThreadPool::Batch {
+    // Task to be evaluated
+    const Task* task;
+    // Number of tasks
+    casadi_int n_task;
+    // Next task to be claimed (guarded by ThreadPool::mtx_)
+    casadi_int next;
+    // Number of completed tasks and combined return flag (guarded by mtx)
+    casadi_int n_done;
+    int flag;
+#ifdef CASADI_WITH_THREAD
+    std::mutex mtx;
+    std::condition_variable cv;
+#endif // CASADI_WITH_THREAD
+  };
+
+  ThreadPool::ThreadPool(casadi_int num_threads, bool pinning) {
+#ifdef CASADI_WITH_THREAD
+    if (num_threads<=0) num_threads = std::thread::hardware_concurrency();
+    size_ = std::max(num_threads, casadi_int(1));
+    stop_ = false;
+    // The calling thread is the first thread, spawn the rest
+    workers_.reserve(size_ - 1);
+    for (casadi_int i=1; i<size_; ++i) {
+      workers_.emplace_back([this]() { work(); });
+#ifdef CASADI_THREAD_POOL_PINNING
+      if (pinning) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(i % std::max(std::thread::hardware_concurrency(), 1u), &cpuset);
+        if (pthread_setaffinity_np(workers_.back().native_handle(), sizeof(cpu_set_t), &cpuset)) {
+          casadi_warning("Failed to pin worker thread " + str(i));
+        }
+      }
+#else // CASADI_THREAD_POOL_PINNING
+      if (pinning && i==1) casadi_warning("Thread pinning not supported on this platform");
+#endif // CASADI_THREAD_POOL_PINNING
+    }
+#else // CASADI_WITH_THREAD
+    size_ = 1;
+#endif // CASADI_WITH_THREAD
+  }
+
+  ThreadPool::~ThreadPool() {
+#ifdef CASADI_WITH_THREAD
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto&& th : workers_) th.join();
+#endif // CASADI_WITH_THREAD
+  }
+
+  ThreadPool& ThreadPool::global() {
+    static ThreadPool pool(GlobalOptions::thread_pool_size, GlobalOptions::thread_pool_pinning);
+    return pool;
+  }
+
+  void ThreadPool::exec(Batch& b, casadi_int k) {
+    int flag;
+    try {
+      flag = (*b.task)(k);
+    } catch (std::exception& e) {
+      flag = 1;
+      casadi_warning("Exception raised: " + std::string(e.what()));
+    } catch (...) {
+      flag = 1;
+      casadi_warning("Uncaught exception.");
+    }
+#ifdef CASADI_WITH_THREAD
+    // Notify while holding the lock: the batch may go out of scope right after
+    std::lock_guard<std::mutex> lock(b.mtx);
+#endif // CASADI_WITH_THREAD
+    b.flag = b.flag || flag;
+    if (++b.n_done==b.n_task) {
+#ifdef CASADI_WITH_THREAD
+      b.cv.notify_all();
+#endif // CASADI_WITH_THREAD
+    }
+  }
+
+  void ThreadPool::work() {
+#ifdef CASADI_WITH_THREAD
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+      cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+      if (stop_) return;
+      // Claim a task from the oldest batch
+      Batch* b = queue_.front();
+      casadi_int k = b->next++;
+      if (b->next==b->n_task) queue_.pop_front();
+      lock.unlock();
+      exec(*b, k);
+      lock.lock();
+    }
+#endif // CASADI_WITH_THREAD
+  }
+
+  int ThreadPool::run(casadi_int n_task, const Task& task) {
+    // Quick return
+    if (n_task<=0) return 0;
+    Batch b;
+    b.task = &task;
+    b.n_task = n_task;
+    b.next = 0;
+    b.n_done = 0;
+    b.flag = 0;
+#ifdef CASADI_WITH_THREAD
+    if (n_task>1 && !workers_.empty()) {
+      // Make tasks available to workers
+      {
+        std::lock_guard<std::mutex> lock(mtx_);
+        queue_.push_back(&b);
+      }
+      cv_.notify_all();
+      // Take part in the evaluation
+      while (true) {
+        casadi_int k;
+        {
+          std::lock_guard<std::mutex> lock(mtx_);
+          if (b.next==n_task) break;
+          k = b.next++;
+          if (b.next==n_task) queue_.erase(std::find(queue_.begin(), queue_.end(), &b));
+        }
+        exec(b, k);
+      }
+      // Wait for tasks claimed by workers
+      std::unique_lock<std::mutex> lock(b.mtx);
+      b.cv.wait(lock, [&b]() { return b.n_done==b.n_task; });
+      return b.flag;
+    }
+#endif // CASADI_WITH_THREAD
+    // Serial evaluation
+    for (casadi_int k=0; k<n_task; ++k) exec(b, k);
+    return b.flag;
+  }
+
+} // namespace casadi
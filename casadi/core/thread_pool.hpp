@@ -0,0 +1,121 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_THREAD_POOL_HPP
+#define CASADI_THREAD_POOL_HPP
+
+#include "casadi_common.hpp"
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#include <mingw.mutex.h>
+#include <mingw.condition_variable.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Persistent pool of worker threads
+
+      Worker threads are created once and then wait for batches of tasks.
+      The thread calling run() takes part in the evaluation of its own batch,
+      which guarantees progress also when tasks themselves submit batches.
+  */
+  class CASADI_EXPORT ThreadPool {
+  public:
+    /// Task: return a nonzero value to signal failure
+    typedef std::function<int(casadi_int task)> Task;
+
+    /** \brief Create a pool with a given number of threads (including the caller)
+
+        \param num_threads Total number of threads, 0 means hardware concurrency
+        \param pinning Pin each worker thread to a dedicated core
+    */
+    explicit ThreadPool(casadi_int num_threads, bool pinning=false);
+
+    /// Destructor, stops and joins all worker threads
+    ~ThreadPool();
+
+    /** \brief Process-wide pool
+
+        Created upon first use, with size and pinning taken from GlobalOptions
+    */
+    static ThreadPool& global();
+
+    /// Number of threads that can work on a batch simultaneously
+    casadi_int size() const { return size_;}
+
+    /** \brief Evaluate tasks 0, ..., n_task-1 and wait for completion
+
+        \return Nonzero if any of the tasks failed
+    */
+    int run(casadi_int n_task, const Task& task);
+
+  private:
+    // A batch of tasks submitted by a call to run
+    struct Batch;
+
+    // Evaluate a task and signal completion
+    static void exec(Batch& b, casadi_int k);
+
+    // Worker thread main loop
+    void work();
+
+    // Number of threads, including the calling thread
+    casadi_int size_;
+
+#ifdef CASADI_WITH_THREAD
+    // Guards queue_ and stop_
+    std::mutex mtx_;
+
+    // Signals new work or shutdown
+    std::condition_variable cv_;
+
+    // Batches with unclaimed tasks
+    std::deque<Batch*> queue_;
+
+    // Shut down requested
+    bool stop_;
+
+    // Worker threads
+    std::vector<std::thread> workers_;
+#endif // CASADI_WITH_THREAD
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_THREAD_POOL_HPP
@@ -24,6 +24,14 @@
 
 
 #include "timing.hpp"
+#include "exception.hpp"
+#include "casadi_misc.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <numeric>
+#include <sstream>
 
 namespace casadi {
 
@@ -62,6 +70,93 @@ namespace casadi {
     n_call += rhs.n_call;
   }
 
+  void InstructionStats::reset(casadi_int n) {
+    n_call.assign(n, 0);
+    t_wall.assign(n, 0);
+  }
+
+  void InstructionStats::join(const InstructionStats& rhs) {
+    if (n_call.empty()) reset(rhs.n_call.size());
+    casadi_assert_dev(n_call.size()==rhs.n_call.size());
+    for (size_t k=0; k<n_call.size(); ++k) {
+      n_call[k] += rhs.n_call[k];
+      t_wall[k] += rhs.t_wall[k];
+    }
+  }
+
+  void InstructionStats::disp(std::ostream& stream, const std::string& fname,
+      const std::vector<std::string>& type, const std::vector<std::string>& descr,
+      casadi_int max_instr) const {
+    casadi_assert_dev(type.size()==n_call.size() && descr.size()==n_call.size());
+    double t_total = std::accumulate(t_wall.begin(), t_wall.end(), 0.0);
+
+    // Totals per instruction type
+    std::map<std::string, std::pair<casadi_int, double> > per_type;
+    for (size_t k=0; k<n_call.size(); ++k) {
+      auto& e = per_type[type[k]];
+      e.first += n_call[k];
+      e.second += t_wall[k];
+    }
+    std::vector<std::pair<double, std::string> > type_order;
+    for (auto&& e : per_type) type_order.push_back(std::make_pair(-e.second.second, e.first));
+    std::sort(type_order.begin(), type_order.end());
+
+    // Instructions sorted by time
+    std::vector<casadi_int> order(n_call.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+      [this](casadi_int i, casadi_int j) { return t_wall[i] > t_wall[j];});
+    if (static_cast<casadi_int>(order.size())>max_instr) order.resize(max_instr);
+
+    // Print
+    std::ios_base::fmtflags f = stream.flags();
+    stream << "Instruction profile of " << fname << ": " << n_call.size() << " instructions, "
+           << std::scientific << std::setprecision(3) << t_total << " s in total" << std::endl;
+    stream << std::setw(20) << "type" << std::setw(12) << "n_call" << std::setw(12) << "t_wall"
+           << std::setw(8) << "%" << std::endl;
+    for (auto&& e : type_order) {
+      const std::pair<casadi_int, double>& v = per_type[e.second];
+      stream << std::setw(20) << e.second << std::setw(12) << v.first << std::setw(12)
+             << std::scientific << std::setprecision(3) << v.second << std::setw(8)
+             << std::fixed << std::setprecision(1) << (t_total>0 ? 100*v.second/t_total : 0.)
+             << std::endl;
+    }
+    stream << std::setw(8) << "#" << std::setw(12) << "n_call" << std::setw(12) << "t_wall"
+           << std::setw(8) << "%" << "  instruction" << std::endl;
+    for (casadi_int k : order) {
+      stream << std::setw(8) << k << std::setw(12) << n_call[k] << std::setw(12)
+             << std::scientific << std::setprecision(3) << t_wall[k] << std::setw(8)
+             << std::fixed << std::setprecision(1) << (t_total>0 ? 100*t_wall[k]/t_total : 0.)
+             << "  " << descr[k] << std::endl;
+    }
+    stream.flags(f);
+  }
+
+  void InstructionStats::to_trace(std::ostream& stream, const std::string& fname,
+      const std::vector<std::string>& type, const std::vector<std::string>& descr) const {
+    casadi_assert_dev(type.size()==n_call.size() && descr.size()==n_call.size());
+    double t_total = std::accumulate(t_wall.begin(), t_wall.end(), 0.0);
+    std::ios_base::fmtflags f = stream.flags();
+    stream << std::fixed << std::setprecision(3);
+    // Times in microseconds
+    stream << "{\"traceEvents\": [" << std::endl;
+    stream << "{\"name\": \"" << json_escape(fname) << "\", \"cat\": \"function\", "
+           << "\"ph\": \"X\", \"ts\": 0, \"dur\": " << 1e6*t_total
+           << ", \"pid\": 0, \"tid\": 0}";
+    double ts = 0;
+    for (size_t k=0; k<n_call.size(); ++k) {
+      if (n_call[k]==0) continue;
+      stream << "," << std::endl;
+      stream << "{\"name\": \"" << json_escape(descr[k]) << "\", \"cat\": \""
+             << json_escape(type[k]) << "\", \"ph\": \"X\", \"ts\": " << 1e6*ts
+             << ", \"dur\": " << 1e6*t_wall[k] << ", \"pid\": 0, \"tid\": 0, "
+             << "\"args\": {\"instruction\": " << k << ", \"n_call\": " << n_call[k] << "}}";
+      ts += t_wall[k];
+    }
+    stream << std::endl << "], \"displayTimeUnit\": \"ns\"}" << std::endl;
+    stream.flags(f);
+  }
+
   ScopedTiming::ScopedTiming(FStats& f) : f_(f) {
     f_.tic();
   }
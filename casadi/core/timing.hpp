@@ -30,6 +30,8 @@
 
 #include <chrono>
 #include <ctime>
+#include <iostream>
+#include <vector>
 
 namespace casadi {
   /// \cond INTERNAL
@@ -84,6 +86,58 @@ namespace casadi {
 
   };
 
+  /** \brief Accumulated evaluation statistics per instruction
+
+      Collected by MXFunction and SXFunction with the option "profile_instructions".
+  */
+  class CASADI_EXPORT InstructionStats {
+    private:
+      /// Time point used for wall time computation
+      std::chrono::time_point<std::chrono::high_resolution_clock> start_wall;
+
+    public:
+      /// Clear the statistics for n instructions
+      void reset(casadi_int n);
+
+      /// Start timing an instruction
+      void tic() { start_wall = std::chrono::high_resolution_clock::now();}
+
+      /// Stop timing instruction k
+      void toc(casadi_int k) {
+        n_call[k]++;
+        t_wall[k] += std::chrono::duration<double>(
+          std::chrono::high_resolution_clock::now() - start_wall).count();
+      }
+
+      /// Add the statistics of rhs
+      void join(const InstructionStats& rhs);
+
+      /** \brief Print a report
+
+          Accumulated times per instruction type, followed by the
+          max_instr most expensive instructions, both sorted by time.
+      */
+      void disp(std::ostream& stream, const std::string& fname,
+                const std::vector<std::string>& type,
+                const std::vector<std::string>& descr, casadi_int max_instr=20) const;
+
+      /** \brief Export in the Chrome trace event format (JSON)
+
+          One complete event per instruction, with the accumulated time as duration,
+          laid out in algorithm order below an event for the function.
+          Can be viewed with chrome://tracing, Perfetto or speedscope.
+      */
+      void to_trace(std::ostream& stream, const std::string& fname,
+                    const std::vector<std::string>& type,
+                    const std::vector<std::string>& descr) const;
+
+      /// Accumulated number of calls per instruction since last reset
+      std::vector<casadi_int> n_call;
+
+      /// Accumulated wall time [s] per instruction since last reset
+      std::vector<double> t_wall;
+  };
+
   class CASADI_EXPORT ScopedTiming {
     public:
       ScopedTiming(FStats& f);
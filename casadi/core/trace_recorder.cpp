@@ -0,0 +1,274 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "trace_recorder.hpp"
+#include "casadi_misc.hpp"
+#include "exception.hpp"
+#include "filesystem_impl.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
+namespace casadi {
+
+  std::atomic<bool> TraceRecorder::enabled_(false);
+
+  // A recorded event
+  struct TraceEvent {
+    // Time since the epoch of the recorder [ns]
+    int64_t t;
+    // Memory object
+    int32_t mem;
+    // Event name
+    int32_t name;
+    // 'B' (begin) or 'E' (end)
+    char phase;
+  };
+
+  // Ring buffer of the events of a thread, only written by the owning thread
+  struct TraceBuffer {
+#ifdef CASADI_WITH_THREAD
+    // Guards the members against concurrent export
+    std::mutex mtx;
+#endif // CASADI_WITH_THREAD
+    std::vector<TraceEvent> ev;
+    size_t next;
+    bool wrapped;
+    int32_t tid;
+    // Generation of the recorder the contents belong to
+    uint64_t generation;
+    // Events in chronological order
+    std::vector<TraceEvent> events() const {
+      std::vector<TraceEvent> ret;
+      if (wrapped) ret.insert(ret.end(), ev.begin() + next, ev.end());
+      ret.insert(ret.end(), ev.begin(), ev.begin() + next);
+      return ret;
+    }
+  };
+
+  // Shared state of the recorder
+  struct TraceState {
+#ifdef CASADI_WITH_THREAD
+    // Guards names and buffers
+    std::mutex mtx;
+#endif // CASADI_WITH_THREAD
+    // Interned names
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> name_id;
+    // Buffers of all threads that have recorded events
+    std::vector< std::shared_ptr<TraceBuffer> > buffers;
+    // Capacity of each buffer
+    std::atomic<casadi_int> capacity{65536};
+    // Incremented to discard the contents of all buffers
+    std::atomic<uint64_t> generation{0};
+    // Time zero
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+  };
+
+  static TraceState& trace_state() {
+    static TraceState s;
+    return s;
+  }
+
+#ifdef CASADI_WITH_THREAD
+#define CASADI_TRACE_LOCK std::lock_guard<std::mutex> lock(st.mtx);
+#define CASADI_TRACE_LOCK_BUFFER(b) std::lock_guard<std::mutex> lock_buffer((b).mtx);
+#else // CASADI_WITH_THREAD
+#define CASADI_TRACE_LOCK
+#define CASADI_TRACE_LOCK_BUFFER(b)
+#endif // CASADI_WITH_THREAD
+
+  // Buffer of the calling thread
+  static thread_local std::shared_ptr<TraceBuffer> trace_local;
+
+  void TraceRecorder::enable(casadi_int capacity) {
+    casadi_assert(capacity>0, "Capacity must be positive");
+    TraceState& st = trace_state();
+    // Buffers are resized by their owning threads
+    if (st.capacity.exchange(capacity)!=capacity) st.generation++;
+    enabled_ = true;
+  }
+
+  void TraceRecorder::disable() {
+    enabled_ = false;
+  }
+
+  void TraceRecorder::clear() {
+    // Buffers are reset by their owning threads
+    trace_state().generation++;
+  }
+
+  int TraceRecorder::intern(const std::string& name) {
+    TraceState& st = trace_state();
+    CASADI_TRACE_LOCK
+    auto it = st.name_id.find(name);
+    if (it!=st.name_id.end()) return it->second;
+    int id = static_cast<int>(st.names.size());
+    st.names.push_back(name);
+    st.name_id[name] = id;
+    return id;
+  }
+
+  void TraceRecorder::record(int name, int mem, char phase) {
+    TraceState& st = trace_state();
+    // Register the buffer of this thread upon first use
+    if (!trace_local) {
+      auto b = std::make_shared<TraceBuffer>();
+      b->next = 0;
+      b->wrapped = false;
+      // Forces allocation below
+      b->generation = st.generation.load() - 1;
+      CASADI_TRACE_LOCK
+      b->tid = static_cast<int32_t>(st.buffers.size());
+      st.buffers.push_back(b);
+      trace_local = b;
+    }
+    TraceBuffer& b = *trace_local;
+    CASADI_TRACE_LOCK_BUFFER(b)
+    // Apply pending resets
+    uint64_t generation = st.generation.load();
+    if (b.generation!=generation) {
+      b.ev.resize(st.capacity.load());
+      b.next = 0;
+      b.wrapped = false;
+      b.generation = generation;
+    }
+    TraceEvent& e = b.ev[b.next];
+    e.t = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - st.epoch).count();
+    e.mem = static_cast<int32_t>(mem);
+    e.name = name;
+    e.phase = phase;
+    if (++b.next==b.ev.size()) {
+      b.next = 0;
+      b.wrapped = true;
+    }
+  }
+
+  // Balanced events of a thread: drop end events whose begin event was overwritten,
+  // close events that have not ended yet
+  static std::vector<TraceEvent> trace_balanced(TraceBuffer& b, uint64_t generation) {
+    std::vector<TraceEvent> ev, ret;
+    {
+      // Copy, the owning thread may still be recording
+      CASADI_TRACE_LOCK_BUFFER(b)
+      if (b.generation==generation) ev = b.events();
+    }
+    std::vector<TraceEvent> open;
+    for (auto&& e : ev) {
+      if (e.phase=='B') {
+        open.push_back(e);
+        ret.push_back(e);
+      } else if (!open.empty()) {
+        open.pop_back();
+        ret.push_back(e);
+      }
+    }
+    int64_t t_end = ev.empty() ? 0 : ev.back().t;
+    while (!open.empty()) {
+      TraceEvent e = open.back();
+      open.pop_back();
+      e.t = t_end;
+      e.phase = 'E';
+      ret.push_back(e);
+    }
+    return ret;
+  }
+
+  void TraceRecorder::save(const std::string& fname, const std::string& format) {
+    casadi_assert(format=="json" || format=="bin",
+      "Unknown trace format '" + format + "', expected 'json' or 'bin'");
+    TraceState& st = trace_state();
+    uint64_t generation = st.generation.load();
+    CASADI_TRACE_LOCK
+    if (format=="json") {
+      std::ofstream of;
+      Filesystem::open(of, fname);
+      of << std::fixed << std::setprecision(3);
+      of << "{\"traceEvents\": [";
+      bool first = true;
+      for (auto&& b : st.buffers) {
+        for (auto&& e : trace_balanced(*b, generation)) {
+          of << (first ? "" : ",") << std::endl;
+          first = false;
+          of << "{\"name\": \"" << json_escape(st.names.at(e.name)) << "\", \"cat\": \"casadi\", "
+             << "\"ph\": \"" << e.phase << "\", \"ts\": " << 1e-3*static_cast<double>(e.t)
+             << ", \"pid\": 0, \"tid\": " << b->tid;
+          if (e.phase=='B') {
+            of << ", \"args\": {\"mem\": " << e.mem << "}";
+          }
+          of << "}";
+        }
+      }
+      of << std::endl << "], \"displayTimeUnit\": \"ns\"}" << std::endl;
+    } else {
+      std::ofstream of;
+      Filesystem::open(of, fname, std::ios_base::out | std::ios_base::binary);
+      auto put = [&of](const void* p, size_t sz) {
+        of.write(static_cast<const char*>(p), static_cast<std::streamsize>(sz));
+      };
+      uint32_t version = 2, n_names = static_cast<uint32_t>(st.names.size());
+      put("CSDTRACE", 8);
+      put(&version, sizeof(version));
+      put(&n_names, sizeof(n_names));
+      for (auto&& n : st.names) {
+        uint32_t len = static_cast<uint32_t>(n.size());
+        put(&len, sizeof(len));
+        put(n.data(), len);
+      }
+      std::vector< std::vector<TraceEvent> > ev;
+      uint64_t n_events = 0;
+      for (auto&& b : st.buffers) {
+        ev.push_back(trace_balanced(*b, generation));
+        n_events += ev.back().size();
+      }
+      put(&n_events, sizeof(n_events));
+      for (size_t i=0; i<ev.size(); ++i) {
+        int32_t tid = st.buffers[i]->tid;
+        for (auto&& e : ev[i]) {
+          put(&e.t, sizeof(e.t));
+          put(&e.mem, sizeof(e.mem));
+          put(&e.name, sizeof(e.name));
+          put(&tid, sizeof(tid));
+          put(&e.phase, sizeof(e.phase));
+        }
+      }
+    }
+  }
+
+} // namespace casadi
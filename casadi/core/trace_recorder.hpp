@@ -0,0 +1,139 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_TRACE_RECORDER_HPP
+#define CASADI_TRACE_RECORDER_HPP
+
+#include "casadi_common.hpp"
+
+#ifndef SWIG
+#include <atomic>
+#include <cstdint>
+#endif // SWIG
+
+namespace casadi {
+
+  /** \brief Records begin/end events of nested Function evaluations
+
+      When enabled, every numerical evaluation of a Function (including the
+      functions called by solvers, e.g. nlpsol -> nlp_jac_g -> integrator) and every
+      factorization/solve of a Linsol is recorded as a pair of begin/end events, tagged
+      with the Function name, the index of the memory object (see Function::checkout)
+      and the thread.
+
+      Each thread records into its own ring buffer of fixed capacity,
+      so that the oldest events are overwritten when the buffer is full.
+      enable, clear and save may be called while other threads evaluate Functions:
+      resets are applied by each thread to its own buffer upon its next event.
+  */
+  class CASADI_EXPORT TraceRecorder {
+  public:
+    /** \brief Start recording
+
+        \param capacity Number of events kept per thread
+    */
+    static void enable(casadi_int capacity=65536);
+
+    /// Stop recording, keeping the events recorded so far
+    static void disable();
+
+    /// Is recording enabled?
+    static bool is_enabled();
+
+    /// Remove all recorded events
+    static void clear();
+
+    /** \brief Save the recorded events
+
+        \param format "json" for the Chrome trace event format (chrome://tracing, Perfetto),
+        "bin" for a compact binary file:
+        magic "CSDTRACE", uint32 version, uint32 n_names, n_names times (uint32 length, chars),
+        uint64 n_events, n_events times (int64 time [ns], int32 memory, int32 name,
+        int32 thread, char phase 'B' or 'E'), in native byte order.
+    */
+    static void save(const std::string& fname, const std::string& format="json");
+
+#ifndef SWIG
+    /// \cond INTERNAL
+    /// Get the identifier of an event name
+    static int intern(const std::string& name);
+
+    /// Record an event
+    static void record(int name, int mem, char phase);
+
+  private:
+    // Recording enabled?
+    static std::atomic<bool> enabled_;
+    /// \endcond
+#endif // SWIG
+  };
+
+#ifndef SWIG
+  /// \cond INTERNAL
+  inline bool TraceRecorder::is_enabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /** \brief Event name, interned on first use */
+  class CASADI_EXPORT TraceName {
+  public:
+    TraceName() : id_(-1) {}
+    int get(const std::string& name, const char* suffix) const {
+      int id = id_.load(std::memory_order_relaxed);
+      if (id<0) {
+        id = TraceRecorder::intern(name + suffix);
+        id_.store(id, std::memory_order_relaxed);
+      }
+      return id;
+    }
+  private:
+    mutable std::atomic<int> id_;
+  };
+
+  /** \brief Records a begin event upon construction and an end event upon destruction */
+  class CASADI_EXPORT TraceScope {
+  public:
+    TraceScope(const TraceName& tn, const std::string& name, int mem,
+               const char* suffix="") : active_(TraceRecorder::is_enabled()) {
+      if (active_) {
+        id_ = tn.get(name, suffix);
+        mem_ = mem;
+        TraceRecorder::record(id_, mem_, 'B');
+      }
+    }
+    ~TraceScope() {
+      if (active_) TraceRecorder::record(id_, mem_, 'E');
+    }
+  private:
+    bool active_;
+    int id_;
+    int mem_;
+  };
+  /// \endcond
+#endif // SWIG
+
+} // namespace casadi
+
+#endif // CASADI_TRACE_RECORDER_HPP
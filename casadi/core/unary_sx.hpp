@@ -40,6 +40,7 @@ namespace casadi {
 
     \identifier{dt} */
 class UnarySX : public SXNode {
+    friend class SXNode;
   private:
 
     /** \brief  Constructor is private, use "create" below
@@ -61,7 +62,8 @@ class UnarySX : public SXNode {
         return ret_val;
       } else {
         // Expression containing free variables
-        return SXElem::create(new UnarySX(op, dep));
+        if (GlobalOptions::sx_hash_consing) return hash_cons(op, dep, nullptr);
+        return SXElem::create(SXNode::alloc<UnarySX>(op, dep));
       }
     }
 
@@ -69,6 +71,7 @@ class UnarySX : public SXNode {
 
         \identifier{dw} */
     ~UnarySX() override {
+      if (hash_consed_) hash_cons_release();
       safe_delete(dep_.assignNoDelete(casadi_limits<SXElem>::nan));
     }
 
@@ -127,7 +130,7 @@ class UnarySX : public SXNode {
     static SXNode* deserialize(DeserializingStream& s, casadi_int op) {
       SXElem dep;
       s.unpack("UnarySX::dep", dep);
-      return new UnarySX(op, dep);
+      return SXNode::alloc<UnarySX>(op, dep);
     }
 };
 
@@ -45,6 +45,12 @@ throw CasadiException("Error in XFunction::" FNAME " for '" + this->name_ + "' "
 
 namespace casadi {
 
+  /** \brief Memory of SXFunction and MXFunction */
+  struct CASADI_EXPORT XFunctionMemory : public FunctionMemory {
+    /// Per-instruction statistics, with option "profile_instructions"
+    InstructionStats instr_stats;
+  };
+
   /** \brief  Internal node class for the base class of SXFunction and MXFunction
 
       (lacks a public counterpart)
@@ -77,6 +83,16 @@ namespace casadi {
         \identifier{xq} */
     void init(const Dict& opts) override;
 
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new XFunctionMemory();}
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<XFunctionMemory*>(mem);}
+
+    /** \brief Get accumulated per-instruction statistics */
+    void get_profile(InstructionStats& stats, std::vector<std::string>& type,
+                     std::vector<std::string>& descr) const override;
+
     ///@{
     /// Is the class able to propagate seeds through the algorithm?
     bool has_spfwd() const override { return true;}
@@ -260,6 +276,9 @@ namespace casadi {
 
         \identifier{yd} */
     std::vector<MatType> out_;
+
+    /// Collect per-instruction statistics during numerical evaluation
+    bool profile_instructions_;
   };
 
   // Template implementations
@@ -271,7 +290,7 @@ namespace casadi {
             const std::vector<MatType>& ex_out,
             const std::vector<std::string>& name_in,
             const std::vector<std::string>& name_out)
-    : FunctionInternal(name), in_(ex_in),  out_(ex_out) {
+    : FunctionInternal(name), in_(ex_in),  out_(ex_out), profile_instructions_(false) {
     // Names of inputs
     if (!name_in.empty()) {
       casadi_assert(ex_in.size()==name_in.size(),
@@ -288,7 +307,7 @@ namespace casadi {
 
   template<typename DerivedType, typename MatType, typename NodeType>
   XFunction<DerivedType, MatType, NodeType>::
-  XFunction(DeserializingStream& s) : FunctionInternal(s) {
+  XFunction(DeserializingStream& s) : FunctionInternal(s), profile_instructions_(false) {
     s.version("XFunction", 1);
     s.unpack("XFunction::in", in_);
     // 'out' member needs to be delayed
@@ -315,6 +334,22 @@ namespace casadi {
     // 'out' member needs to be delayed
   }
 
+  template<typename DerivedType, typename MatType, typename NodeType>
+  void XFunction<DerivedType, MatType, NodeType>::
+  get_profile(InstructionStats& stats, std::vector<std::string>& type,
+              std::vector<std::string>& descr) const {
+    casadi_assert(profile_instructions_,
+      "No instruction profile for '" + name_ + "': Set option 'profile_instructions'.");
+    // Sum over memory objects
+    stats.reset(n_instructions());
+    for (int i=0; has_memory(i); ++i) {
+      const InstructionStats& s = static_cast<XFunctionMemory*>(memory(i))->instr_stats;
+      if (!s.n_call.empty()) stats.join(s);
+    }
+    // Classify and describe instructions
+    static_cast<const DerivedType*>(this)->instruction_labels(type, descr);
+  }
+
   template<typename DerivedType, typename MatType, typename NodeType>
   void XFunction<DerivedType, MatType, NodeType>::init(const Dict& opts) {
     // Call the init function of the base class
@@ -325,6 +360,8 @@ namespace casadi {
     for (auto&& op : opts) {
       if (op.first=="allow_duplicate_io_names") {
         allow_duplicate_io_names = op.second;
+      } else if (op.first=="profile_instructions") {
+        profile_instructions_ = op.second;
       }
     }
 
@@ -209,6 +209,8 @@ namespace casadi {
     // Setup NLP functions
     create_function("nlp_f", {"x", "p"}, {"f"});
     create_function("nlp_g", {"x", "p"}, {"g"});
+    // With caching, f and g are evaluated together: IPOPT requests both at every trial point
+    if (cache_evaluations_) create_function("nlp_fg", {"x", "p"}, {"f", "g"});
     if (!has_function("nlp_grad_f")) {
       create_function("nlp_grad_f", {"x", "p"}, {"f", "grad:f:x"});
     }
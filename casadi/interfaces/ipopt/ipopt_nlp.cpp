@@ -90,6 +90,10 @@ namespace casadi {
     mem_->arg[1] = mem_->d_nlp.p;
     mem_->res[0] = &obj_value;
     try {
+      if (solver_.has_function("nlp_fg")) {
+        mem_->res[1] = nullptr;
+        return solver_.calc_function(mem_, "nlp_fg")==0;
+      }
       return solver_.calc_function(mem_, "nlp_f")==0;
     } catch(KeyboardInterruptException& ex) {
       casadi_warning("KeyboardInterruptException");
@@ -125,8 +129,13 @@ namespace casadi {
   bool IpoptUserClass::eval_g(Index n, const Number* x, bool new_x, Index m, Number* g) {
     mem_->arg[0] = x;
     mem_->arg[1] = mem_->d_nlp.p;
-    mem_->res[0] = g;
     try {
+      if (solver_.has_function("nlp_fg")) {
+        mem_->res[0] = nullptr;
+        mem_->res[1] = g;
+        return solver_.calc_function(mem_, "nlp_fg")==0;
+      }
+      mem_->res[0] = g;
       return solver_.calc_function(mem_, "nlp_g")==0;
     } catch(KeyboardInterruptException& ex) {
       casadi_warning("KeyboardInterruptException");
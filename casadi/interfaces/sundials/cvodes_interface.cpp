@@ -500,7 +500,7 @@ int CvodesInterface::psolveF(double t, N_Vector x, N_Vector xdot, N_Vector r,
     casadi_copy(v, s.nx_, m->tmp1);
 
     // Solve for undifferentiated right-hand-side, save to output
-    if (s.linsolF_.solve(m->jacF, m->tmp1, 1, false, m->mem_linsolF)) return 1;
+    if (s.solve_precon(m, t, NV_DATA_S(x), nullptr, m->gamma, m->tmp1, 1, false)) return 1;
     v = NV_DATA_S(z); // possibly different from r
     casadi_copy(m->tmp1, s.nx1_, v);
 
@@ -517,7 +517,8 @@ int CvodesInterface::psolveF(double t, N_Vector x, N_Vector xdot, N_Vector r,
       }
 
       // Solve for sensitivity right-hand-sides
-      if (s.linsolF_.solve(m->jacF, m->tmp1 + s.nx1_, s.nfwd_, false, m->mem_linsolF)) return 1;
+      if (s.solve_precon(m, t, NV_DATA_S(x), nullptr, m->gamma, m->tmp1 + s.nx1_, s.nfwd_,
+        false)) return 1;
 
       // Save to output, reordered
       casadi_copy(m->tmp1 + s.nx1_, s.nx_ - s.nx1_, v + s.nx1_);
@@ -541,7 +542,7 @@ int CvodesInterface::psolveB(double t, N_Vector x, N_Vector xB, N_Vector xdotB,
     casadi_copy(v, s.nrx_, m->tmp1);
 
     // Solve for undifferentiated right-hand-side, save to output
-    if (s.linsolF_.solve(m->jacF, m->tmp1, s.nadj_, true, m->mem_linsolF)) return 1;
+    if (s.solve_precon(m, t, NV_DATA_S(x), nullptr, m->gamma, m->tmp1, s.nadj_, true)) return 1;
     v = NV_DATA_S(zvecB); // possibly different from rvecB
     casadi_copy(m->tmp1, s.nrx1_ * s.nadj_, v);
 
@@ -559,8 +560,8 @@ int CvodesInterface::psolveB(double t, N_Vector x, N_Vector xB, N_Vector xdotB,
       }
 
       // Solve for sensitivity right-hand-sides
-      if (s.linsolF_.solve(m->jacF, m->tmp1 + s.nx1_, s.nadj_ * s.nfwd_,
-        true, m->mem_linsolF)) return 1;
+      if (s.solve_precon(m, t, NV_DATA_S(x), nullptr, m->gamma, m->tmp1 + s.nx1_,
+        s.nadj_ * s.nfwd_, true)) return 1;
 
       // Save to output, reordered
       casadi_copy(m->tmp1 + s.nx1_, s.nx_ - s.nx1_, v + s.nx1_);
@@ -582,6 +583,12 @@ int CvodesInterface::psetupF(double t, N_Vector x, N_Vector xdot, booleantype jo
     // Store gamma for later
     m->gamma = gamma;
 
+    // Nothing to prepare for a user-supplied preconditioner
+    if (s.has_precon_function()) {
+      if (jcurPtr) *jcurPtr = 1;
+      return 0;
+    }
+
     // Sparsity patterns
     const Sparsity& sp_jac_ode_x = s.get_function("jacF").sparsity_out(0);
     const Sparsity& sp_jacF = s.linsolF_.sparsity();
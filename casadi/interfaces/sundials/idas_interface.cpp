@@ -668,7 +668,7 @@ int IdasInterface::psolveF(double t, N_Vector xz, N_Vector xzdot, N_Vector rr,
     }
 
     // Solve for undifferentiated right-hand-side, save to output
-    if (s.linsolF_.solve(m->jacF, m->tmp1, 1, false, m->mem_linsolF))
+    if (s.solve_precon(m, t, NV_DATA_S(xz), NV_DATA_S(xz) + s.nx_, cj, m->tmp1, 1, false))
       return 1;
     vx = NV_DATA_S(zvec); // possibly different from rvec
     vz = vx + s.nx_;
@@ -696,8 +696,8 @@ int IdasInterface::psolveF(double t, N_Vector xz, N_Vector xzdot, N_Vector rr,
       }
 
       // Solve for sensitivity right-hand-sides
-      if (s.linsolF_.solve(m->jacF, m->tmp1 + s.nx1_ + s.nz1_, s.nfwd_,
-        false, m->mem_linsolF)) return 1;
+      if (s.solve_precon(m, t, NV_DATA_S(xz), NV_DATA_S(xz) + s.nx_, cj,
+        m->tmp1 + s.nx1_ + s.nz1_, s.nfwd_, false)) return 1;
 
       // Save to output, reordered
       v_it = m->tmp1 + s.nx1_ + s.nz1_;
@@ -730,7 +730,7 @@ int IdasInterface::solve_transposed(IdasMemory* m, double t, const double* xz, c
   }
 
   // Solve for undifferentiated right-hand-side, save to output
-  if (linsolF_.solve(m->jacF, m->tmp1, nadj_, true, m->mem_linsolF)) return 1;
+  if (solve_precon(m, t, xz, xz + nx_, m->cj_last, m->tmp1, nadj_, true)) return 1;
   for (int a = 0; a < nadj_; ++a) {
     casadi_copy(m->tmp1 + a * (nrx1_ + nrz1_), nrx1_, sol + a * nrx1_);
     casadi_copy(m->tmp1 + a * (nrx1_ + nrz1_) + nrx1_, nrz1_, sol + nrx_ + a * nrz1_);
@@ -761,8 +761,8 @@ int IdasInterface::solve_transposed(IdasMemory* m, double t, const double* xz, c
     }
 
     // Solve for sensitivity right-hand-sides
-    if (linsolF_.solve(m->jacF, m->tmp1 + nrx1_ * nadj_ + nrz1_ * nadj_,
-      nadj_ * nfwd_, true, m->mem_linsolF)) return 1;
+    if (solve_precon(m, t, xz, xz + nx_, m->cj_last, m->tmp1 + nrx1_ * nadj_ + nrz1_ * nadj_,
+      nadj_ * nfwd_, true)) return 1;
 
     // Save to output, reordered
     v_it = m->tmp1 + (nrx1_ + nrz1_) * nadj_;
@@ -832,6 +832,12 @@ int IdasInterface::psetupF(double t, N_Vector xz, N_Vector xzdot, N_Vector rr,
     auto m = to_mem(user_data);
     auto& s = m->self;
 
+    // Nothing to prepare for a user-supplied preconditioner
+    if (s.has_precon_function()) {
+      m->cj_last = cj;
+      return 0;
+    }
+
     // Sparsity patterns
     const Function& jacF = s.get_function("jacF");
     const Sparsity& sp_jac_ode_x = jacF.sparsity_out(JACF_ODE_X);
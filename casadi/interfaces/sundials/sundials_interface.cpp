@@ -66,6 +66,23 @@ const Options SundialsInterface::options_
     {"use_preconditioner",
       {OT_BOOL,
       "Precondition the iterative solver [default: true]"}},
+    {"preconditioner",
+      {OT_STRING,
+      "Preconditioner for the iterative Newton schemes: "
+      "FULL (factorize the iteration matrix with linear_solver) | "
+      "block_jacobi (factorize its diagonal blocks only) | "
+      "incomplete_ldl (LDL^T factorization without fill-in, using linear solver 'ldl')"}},
+    {"preconditioner_block_size",
+      {OT_INT,
+      "Size of the diagonal blocks for the block_jacobi preconditioner "
+      "[default: the blocks of the block triangular form of the Jacobian sparsity]"}},
+    {"preconditioner_function",
+      {OT_FUNCTION,
+      "User-supplied preconditioner, replacing the factorization of the iteration matrix. "
+      "Inputs: t, x, z, p, u, gamma, tr, r. Output: approximate solution of the linear system "
+      "with right-hand-side r, or of the transposed system if tr is nonzero. The iteration matrix "
+      "is I - gamma*df/dx for CVODES and [df_ode/dx - gamma*I, df_ode/dz; df_alg/dx, df_alg/dz] "
+      "for IDAS"}},
     {"stop_at_end",
       {OT_BOOL,
       "[DEPRECATED] Stop the integrator at the end of the interval"}},
@@ -111,11 +128,46 @@ const Options SundialsInterface::options_
     }
 };
 
+/// Pattern restricted to its diagonal blocks, of a given size or from the block triangular form
+static Sparsity block_diagonal(const Sparsity& sp, casadi_int block_size) {
+  casadi_int n = sp.size2();
+  std::vector<casadi_int> block_row(n), block_col(n);
+  if (block_size > 0) {
+    for (casadi_int i = 0; i < n; ++i) block_row[i] = block_col[i] = i / block_size;
+  } else {
+    std::vector<casadi_int> rowperm, colperm, rowblock, colblock, coarse_rowblock, coarse_colblock;
+    casadi_int nb = sp.btf(rowperm, colperm, rowblock, colblock, coarse_rowblock, coarse_colblock);
+    if (nb == 1) {
+      casadi_warning("The Jacobian sparsity has a single diagonal block, the block_jacobi "
+        "preconditioner is a full factorization. Consider setting preconditioner_block_size.");
+    }
+    for (casadi_int b = 0; b < nb; ++b) {
+      for (casadi_int k = rowblock[b]; k < rowblock[b + 1]; ++k) block_row[rowperm[k]] = b;
+      for (casadi_int k = colblock[b]; k < colblock[b + 1]; ++k) block_col[colperm[k]] = b;
+    }
+  }
+  // Keep entries within a block, and the diagonal
+  std::vector<casadi_int> row, col;
+  const casadi_int *colind = sp.colind(), *r = sp.row();
+  for (casadi_int c = 0; c < n; ++c) {
+    for (casadi_int k = colind[c]; k < colind[c + 1]; ++k) {
+      if (block_row[r[k]] == block_col[c]) {
+        row.push_back(r[k]);
+        col.push_back(c);
+      }
+    }
+  }
+  return Sparsity::triplet(n, n, row, col) + Sparsity::diag(n);
+}
+
 void SundialsInterface::init(const Dict& opts) {
   // Call the base class method
   Integrator::init(opts);
 
   // Default options
+  std::string preconditioner = "full";
+  casadi_int precon_block_size = -1;
+  Function precon_fcn;
   abstol_ = 1e-8;
   reltol_ = 1e-6;
   max_num_steps_ = 10000;
@@ -151,6 +203,12 @@ void SundialsInterface::init(const Dict& opts) {
       }
     } else if (op.first=="use_preconditioner") {
       use_precon_ = op.second;
+    } else if (op.first=="preconditioner") {
+      preconditioner = op.second.to_string();
+    } else if (op.first=="preconditioner_block_size") {
+      precon_block_size = op.second;
+    } else if (op.first=="preconditioner_function") {
+      precon_fcn = op.second;
     } else if (op.first=="max_krylov") {
       max_krylov_ = op.second;
     } else if (op.first=="newton_scheme") {
@@ -197,6 +255,15 @@ void SundialsInterface::init(const Dict& opts) {
     casadi_error("Unknown Newton scheme: " + newton_scheme);
   }
 
+  // Approximate preconditioners only make sense for the iterative schemes
+  casadi_assert(preconditioner=="full" || preconditioner=="block_jacobi"
+    || preconditioner=="incomplete_ldl", "Unknown preconditioner: " + preconditioner);
+  bool exact_precon = preconditioner=="full" && precon_fcn.is_null();
+  casadi_assert(exact_precon || newton_scheme_!=SD_DIRECT,
+    "Preconditioners other than 'full' require an iterative Newton scheme");
+  casadi_assert(exact_precon || nrz_ == 0,
+    "Preconditioners other than 'full' are not supported with backward algebraic variables");
+
   // Interpolation_type
   if (interpolation_type=="hermite") {
     interp_ = SD_HERMITE;
@@ -232,11 +299,45 @@ void SundialsInterface::init(const Dict& opts) {
     linsolF_ = d->linsolF_;
     jacF_sp = linsolF_.sparsity();
   }
-  alloc_w(jacF_sp.nnz(), true);  // jacF
 
   // Linear solver for forward problem
   if (linsolF_.is_null()) {
-    linsolF_ = Linsol("linsolF", linear_solver_, jacF_sp, linear_solver_options_);
+    if (preconditioner=="block_jacobi") {
+      // Iteration matrix restricted to its diagonal blocks
+      linsolF_ = Linsol("linsolF", linear_solver_,
+        block_diagonal(jacF_sp, precon_block_size), linear_solver_options_);
+    } else if (preconditioner=="incomplete_ldl") {
+      linsolF_ = Linsol("linsolF", "ldl", jacF_sp, {{"incomplete", true}});
+    } else {
+      linsolF_ = Linsol("linsolF", linear_solver_, jacF_sp, linear_solver_options_);
+    }
+  }
+  alloc_w(linsolF_.sparsity().nnz(), true);  // jacF
+
+  // User-supplied preconditioner
+  if (!precon_fcn.is_null()) {
+    casadi_assert(precon_fcn.n_in()==PRECON_NUM_IN && precon_fcn.n_out()==1,
+      "Preconditioner function must have " + str(PRECON_NUM_IN) + " inputs "
+      "(t, x, z, p, u, gamma, tr, r) and one output");
+    // Inputs are passed as buffers of exactly this length, cf. solve_precon
+    std::vector<casadi_int> precon_nnz(PRECON_NUM_IN);
+    precon_nnz[PRECON_T] = precon_nnz[PRECON_GAMMA] = precon_nnz[PRECON_TR] = 1;
+    precon_nnz[PRECON_X] = nx1_;
+    precon_nnz[PRECON_Z] = nz1_;
+    precon_nnz[PRECON_P] = np1_;
+    precon_nnz[PRECON_U] = nu1_;
+    precon_nnz[PRECON_R] = nx1_ + nz1_;
+    const char* precon_names[] = {"t", "x", "z", "p", "u", "gamma", "tr", "r"};
+    for (casadi_int i = 0; i < PRECON_NUM_IN; ++i) {
+      casadi_assert(precon_fcn.nnz_in(i)==precon_nnz[i],
+        "Preconditioner function: input " + str(i) + " (" + precon_names[i] + ") must have "
+        + str(precon_nnz[i]) + " nonzeros, got " + str(precon_fcn.nnz_in(i)));
+    }
+    casadi_assert(precon_fcn.nnz_out(0)==nx1_ + nz1_,
+      "Preconditioner function: solution must have " + str(nx1_ + nz1_) + " nonzeros, got "
+      + str(precon_fcn.nnz_out(0)));
+    set_function(precon_fcn, "precon", true);
+    alloc_w(nx1_ + nz1_, true);  // precon_sol
   }
 
   // Attach functions to calculate DAE and quadrature RHS all-at-once
@@ -281,6 +382,9 @@ void SundialsInterface::set_work(void* mem, const double**& arg, double**& res,
 
   // Work vectors
   m->jacF = w; w += linsolF_.sparsity().nnz();
+  if (has_precon_function()) {
+    m->precon_sol = w; w += nx1_ + nz1_;
+  }
 
   // Work vectors
   const Function& jacF = get_function("jacF");
@@ -707,6 +811,31 @@ int SundialsInterface::calc_quadB(SundialsMemory* m, double t, const double* x,
   return 0;
 }
 
+int SundialsInterface::solve_precon(SundialsMemory* m, double t, const double* x,
+    const double* z, double gamma, double* rhs, casadi_int nrhs, bool tr) const {
+  // Factorized iteration matrix, or an approximation of it
+  if (!has_precon_function()) {
+    return linsolF_.solve(m->jacF, rhs, nrhs, tr, m->mem_linsolF);
+  }
+  // User-supplied preconditioner, one right-hand-side at a time
+  double tr_val = tr ? 1 : 0;
+  for (casadi_int i = 0; i < nrhs; ++i) {
+    m->arg[PRECON_T] = &t;
+    m->arg[PRECON_X] = x;
+    m->arg[PRECON_Z] = z;
+    m->arg[PRECON_P] = m->p;
+    m->arg[PRECON_U] = m->u;
+    m->arg[PRECON_GAMMA] = &gamma;
+    m->arg[PRECON_TR] = &tr_val;
+    m->arg[PRECON_R] = rhs;
+    m->res[0] = m->precon_sol;
+    if (calc_function(m, "precon")) return 1;
+    casadi_copy(m->precon_sol, nx1_ + nz1_, rhs);
+    rhs += nx1_ + nz1_;
+  }
+  return 0;
+}
+
 int SundialsInterface::calc_jtimesF(SundialsMemory* m, double t, const double* x, const double* z,
     const double* fwd_x, const double* fwd_z, double* fwd_ode, double* fwd_alg) const {
   // Evaluate nondifferentiated
@@ -56,6 +56,9 @@ namespace casadi {
     // Jacobian
     double *jacF;
 
+    // Output of the user-supplied preconditioner
+    double *precon_sol;
+
     /// Stats, forward integration
     long nsteps, nfevals, nlinsetups, netfails;
     int qlast, qcur;
@@ -144,6 +147,13 @@ namespace casadi {
     int calc_jacF(SundialsMemory* m, double t, const double* x, const double* z,
       double* jac_ode_x, double* jac_alg_x, double* jac_ode_z, double* jac_alg_z) const;
 
+    // Apply the preconditioner in-place to nrhs right-hand-sides
+    int solve_precon(SundialsMemory* m, double t, const double* x, const double* z,
+      double gamma, double* rhs, casadi_int nrhs, bool tr) const;
+
+    // Is the preconditioner a user-supplied Function?
+    bool has_precon_function() const { return has_function("precon");}
+
     /// Get all statistics
     Dict get_stats(void* mem) const override;
 
@@ -182,6 +192,8 @@ namespace casadi {
       JTIMESF_FWD_Z, JTIMESF_NUM_IN};
     enum JtimesFOut { JTIMESF_FWD_ODE, JTIMESF_FWD_ALG, JTIMESF_NUM_OUT};
     enum JacFOut {JACF_ODE_X, JACF_ALG_X, JACF_ODE_Z, JACF_ALG_Z, JACF_NUM_OUT};
+    enum PreconIn {PRECON_T, PRECON_X, PRECON_Z, PRECON_P, PRECON_U, PRECON_GAMMA, PRECON_TR,
+      PRECON_R, PRECON_NUM_IN};
     ///@}
 
     ///@{
@@ -88,7 +88,7 @@ namespace casadi {
     return repmat(ret, deg_);
   }
   MX Collocation::algebraic_state_output(const MX& Z) const {
-    return Z(Slice(Z.size1()-nz_, Z.size1()));
+    return Z(Slice(Z.size1()-nz_, Z.size1()), Slice());
   }
 
   void Collocation::setup_step() {
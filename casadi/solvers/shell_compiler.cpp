@@ -28,6 +28,15 @@
 #include "casadi/core/casadi_meta.hpp"
 #include "casadi/core/casadi_logger.hpp"
 #include <fstream>
+#include <iomanip>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
 
 // Set default object file suffix
 #ifndef OBJECT_FILE_SUFFIX
@@ -57,17 +66,26 @@ namespace casadi {
   ShellCompiler::ShellCompiler(const std::string& name) :
     ImporterInternal(name) {
       handle_ = nullptr;
+      cached_ = false;
   }
 
   ShellCompiler::~ShellCompiler() {
     if (handle_) close_shared_library(handle_);
 
     if (cleanup_) {
-      if (remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
-      if (remove(obj_name_.c_str())) casadi_warning("Failed to remove " + obj_name_);
-      for (const std::string& s : extra_suffixes_) {
-        std::string name = base_name_+s;
-        remove(name.c_str());
+      if (!cached_ && remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
+      if (!obj_name_.empty() && remove(obj_name_.c_str())) {
+        casadi_warning("Failed to remove " + obj_name_);
+      }
+      // Not set if the library was taken from the cache
+      if (!base_name_.empty()) {
+        for (const std::string& s : extra_suffixes_) {
+          std::string name = base_name_+s;
+          remove(name.c_str());
+        }
+      }
+      for (const std::string& s : unit_obj_names_) {
+        if (remove(s.c_str())) casadi_warning("Failed to remove " + s);
       }
     }
   }
@@ -125,9 +143,48 @@ namespace casadi {
         "This is desired for thread-safety. "
         "This behaviour may defeat caching compiler wrappers. "
         "Default: true"}},
+      {"cache_dir",
+       {OT_STRING,
+        "Directory of a persistent cache of compiled shared libraries, "
+        "keyed by a hash of the source file, the compiler and linker commands "
+        "and the CasADi version. Headers included by the source are not part of the key. "
+        "Entries are populated with atomic renames and may be shared between processes. "
+        "Must end with a file separator. Default: '' (no caching)"}},
+      {"units",
+       {OT_STRINGVECTOR,
+        "Additional source files, compiled in parallel with the main source file "
+        "and linked into the same shared library. "
+        "See the n_units option of CodeGenerator. Default: None"}},
+      {"num_threads",
+       {OT_INT,
+        "Maximum number of concurrent compiler processes. "
+        "Default: 0 (hardware concurrency)"}}
      }
   };
 
+  namespace {
+    // 128-bit content hash as a hexadecimal string, two FNV-1a variants
+    std::string content_hash(const std::string& s) {
+      uint64_t h[2] = {14695981039346656037ULL, 0x6c62272e07bb0142ULL};
+      for (unsigned char c : s) {
+        h[0] = (h[0] ^ c) * 1099511628211ULL;
+        h[1] = (h[1] ^ (c ^ 0x5c)) * 0x100000001b3ULL;
+        h[1] ^= h[1] >> 29;
+      }
+      std::stringstream ss;
+      ss << std::hex << std::setfill('0') << std::setw(16) << h[0] << std::setw(16) << h[1];
+      return ss.str();
+    }
+
+    // Have relative paths start with ./
+    std::string explicit_path(const std::string& path) {
+#ifndef _WIN32
+      if (path.at(0)!='/') return "./" + path;
+#endif // _WIN32
+      return path;
+    }
+  } // namespace
+
   void ShellCompiler::init(const Dict& opts) {
     // Base class
     ImporterInternal::init(opts);
@@ -138,6 +195,9 @@ namespace casadi {
     bool temp_suffix = true;
     std::string bare_name = "tmp_casadi_compiler_shell";
     std::string directory = "";
+    std::string cache_dir = "";
+    std::vector<std::string> units;
+    casadi_int num_threads = 0;
 
     std::vector<std::string> compiler_flags;
     std::vector<std::string> linker_flags;
@@ -188,6 +248,42 @@ namespace casadi {
         bare_name = op.second.to_string();
       } else if (op.first=="temp_suffix") {
         temp_suffix = op.second;
+      } else if (op.first=="cache_dir") {
+        cache_dir = op.second.to_string();
+      } else if (op.first=="units") {
+        units = op.second.to_string_vector();
+      } else if (op.first=="num_threads") {
+        num_threads = op.second;
+        casadi_assert(num_threads>=0, "Option num_threads must be >=0");
+      }
+    }
+
+    // Look up the compilation cache
+    std::string cache_name;
+    if (!cache_dir.empty()) {
+      std::ifstream src(name_, std::ios::binary);
+      casadi_assert(src.good(), "Cannot read source file '" + name_ + "' for caching");
+      std::stringstream key;
+      key << src.rdbuf();
+      for (const std::string& u : units) {
+        std::ifstream usrc(u, std::ios::binary);
+        casadi_assert(usrc.good(), "Cannot read source file '" + u + "' for caching");
+        key << '\0' << usrc.rdbuf();
+      }
+      key << '\0' << CasadiMeta::version() << '\0' << CasadiMeta::git_revision();
+      key << '\0' << compiler;
+      for (const std::string& f : compiler_flags) key << '\0' << f;
+      key << '\0' << compiler_setup << '\0' << linker;
+      for (const std::string& f : linker_flags) key << '\0' << f;
+      key << '\0' << linker_setup;
+      cache_name = explicit_path(cache_dir + "casadi_jit_" + content_hash(key.str())
+        + SHARED_LIBRARY_SUFFIX);
+      if (std::ifstream(cache_name).good()) {
+        if (verbose_) casadi_message("using cached \"" + cache_name + "\"");
+        bin_name_ = cache_name;
+        cached_ = true;
+        handle_ = open_shared_library(bin_name_, get_search_paths(), "ShellCompiler::init");
+        return;
       }
     }
 
@@ -198,45 +294,72 @@ namespace casadi {
       obj_name_ = directory + bare_name + suffix;
     }
     base_name_ = std::string(obj_name_.begin(), obj_name_.begin()+obj_name_.size()-suffix.size());
-    bin_name_ = base_name_+SHARED_LIBRARY_SUFFIX;
-
-#ifndef _WIN32
-    // Have relative paths start with ./
-    if (obj_name_.at(0)!='/') {
-      obj_name_ = "./" + obj_name_;
+    if (cache_name.empty()) {
+      bin_name_ = base_name_+SHARED_LIBRARY_SUFFIX;
+    } else {
+      // Link into the cache directory, so that the entry can be created by a rename
+      bin_name_ = temporary_file(cache_dir + "tmp_casadi_jit_", SHARED_LIBRARY_SUFFIX);
     }
 
-    if (bin_name_.at(0)!='/') {
-      bin_name_ = "./" + bin_name_;
-    }
-#endif // _WIN32
+    obj_name_ = explicit_path(obj_name_);
+    bin_name_ = explicit_path(bin_name_);
 
-    // Construct the compiler command
-    std::stringstream cccmd;
-    cccmd << compiler;
-    for (auto i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
-      cccmd << " " << *i;
+    // Source and object files
+    std::vector<std::string> sources = {name_}, objects = {obj_name_};
+    for (casadi_int k=0; k<units.size(); ++k) {
+      unit_obj_names_.push_back(explicit_path(base_name_ + "_u" + str(k+1) + suffix));
+      sources.push_back(units[k]);
+      objects.push_back(unit_obj_names_.back());
     }
-    cccmd << " " << compiler_setup;
 
-    // C/C++ source file
-    cccmd << " " << name_;
+    // Construct the compiler commands
+    std::vector<std::string> cccmds;
+    for (casadi_int k=0; k<sources.size(); ++k) {
+      std::stringstream cccmd;
+      cccmd << compiler;
+      for (auto i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
+        cccmd << " " << *i;
+      }
+      cccmd << " " << compiler_setup;
 
-    // Temporary object file
-    cccmd << " " + compiler_output_flag << obj_name_;
+      // C/C++ source file
+      cccmd << " " << sources[k];
 
-    // Compile into an object
-    if (verbose_) casadi_message("calling \"" + cccmd.str() + "\"");
-    if (system(cccmd.str().c_str())) {
-      casadi_error("Compilation failed. Tried \"" + cccmd.str() + "\"");
+      // Temporary object file
+      cccmd << " " + compiler_output_flag << objects[k];
+      cccmds.push_back(cccmd.str());
+      if (verbose_) casadi_message("calling \"" + cccmds.back() + "\"");
+    }
+
+    // Compile into objects, in parallel if there are several
+    std::vector<int> failed(cccmds.size(), 0);
+#ifdef CASADI_WITH_THREAD
+    if (num_threads==0) num_threads = std::thread::hardware_concurrency();
+    num_threads = std::max(std::min(num_threads, static_cast<casadi_int>(cccmds.size())),
+                           casadi_int(1));
+    std::vector<std::thread> threads;
+    for (casadi_int t=0; t<num_threads; ++t) {
+      threads.emplace_back([&, t]() {
+        for (casadi_int k=t; k<cccmds.size(); k+=num_threads) {
+          failed[k] = system(cccmds[k].c_str());
+        }
+      });
+    }
+    for (auto&& th : threads) th.join();
+#else // CASADI_WITH_THREAD
+    for (casadi_int k=0; k<cccmds.size(); ++k) failed[k] = system(cccmds[k].c_str());
+#endif // CASADI_WITH_THREAD
+    for (casadi_int k=0; k<cccmds.size(); ++k) {
+      if (failed[k]) casadi_error("Compilation failed. Tried \"" + cccmds[k] + "\"");
     }
 
     // Link step
     std::stringstream ldcmd;
     ldcmd << linker;
 
-    // Temporary file
-    ldcmd << " " << obj_name_ << " " + linker_output_flag + bin_name_;
+    // Temporary files
+    for (const std::string& o : objects) ldcmd << " " << o;
+    ldcmd << " " + linker_output_flag + bin_name_;
 
     // Add flags
     for (auto i=linker_flags.begin(); i!=linker_flags.end(); ++i) {
@@ -250,6 +373,25 @@ namespace casadi {
       casadi_error("Linking failed. Tried \"" + ldcmd.str() + "\"");
     }
 
+    // Publish in the cache, replacing any entry created concurrently
+    if (!cache_name.empty()) {
+      if (rename(bin_name_.c_str(), cache_name.c_str())) {
+        // E.g. Windows does not replace existing files
+        casadi_assert(std::ifstream(cache_name).good(),
+          "Failed to add \"" + bin_name_ + "\" to the cache as \"" + cache_name + "\"");
+        remove(bin_name_.c_str());
+      }
+      // Side products of the linker, e.g. .exp/.lib, are named after the temporary binary
+      std::string link_base(bin_name_.begin(),
+        bin_name_.begin()+bin_name_.size()-std::string(SHARED_LIBRARY_SUFFIX).size());
+      for (const std::string& s : extra_suffixes_) {
+        std::string name = link_base+s;
+        remove(name.c_str());
+      }
+      bin_name_ = cache_name;
+      cached_ = true;
+    }
+
     std::vector<std::string> search_paths = get_search_paths();
     handle_ = open_shared_library(bin_name_, search_paths, "ShellCompiler::init");
 
@@ -100,9 +100,15 @@ namespace casadi {
     /// Extra files
     std::vector<std::string> extra_suffixes_;
 
+    /// Object files of additional sources
+    std::vector<std::string> unit_obj_names_;
+
     /// Cleanup temporary files when unloading
     bool cleanup_;
 
+    /// Shared library is an entry of the compilation cache, never removed
+    bool cached_;
+
     // Shared library handle
     handle_t handle_;
   };
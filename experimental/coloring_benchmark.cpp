@@ -0,0 +1,149 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of sequential and speculative parallel graph coloring
+
+  Colors the column intersection graph of a large random Jacobian pattern
+  (uni_coloring) and a symmetric Hessian pattern (star_coloring), sequentially and
+  with the speculative parallel algorithms on an increasing number of threads.
+  Reports the number of colors, wall time and whether the coloring is valid.
+*/
+
+#include <casadi/casadi.hpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace casadi;
+
+typedef std::chrono::steady_clock Clock;
+
+double seconds(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// Color of each column
+std::vector<casadi_int> colors(const Sparsity& D) {
+  std::vector<casadi_int> ret(D.size1());
+  for (casadi_int c=0; c<D.size2(); ++c) {
+    for (casadi_int el=D.colind()[c]; el<D.colind()[c+1]; ++el) ret[D.row()[el]] = c;
+  }
+  return ret;
+}
+
+// No two columns sharing a row have the same color
+bool valid_uni(const Sparsity& A, const Sparsity& D) {
+  std::vector<casadi_int> color = colors(D);
+  Sparsity AT = A.T();
+  std::vector<casadi_int> seen(D.size2(), -1);
+  for (casadi_int r=0; r<AT.size2(); ++r) {
+    for (casadi_int el=AT.colind()[r]; el<AT.colind()[r+1]; ++el) {
+      casadi_int c = color[AT.row()[el]];
+      if (seen[c]==r) return false;
+      seen[c] = r;
+    }
+  }
+  return true;
+}
+
+// Distance-1 coloring without two-colored paths on four vertices
+bool valid_star(const Sparsity& H, const Sparsity& D) {
+  std::vector<casadi_int> color = colors(D);
+  const casadi_int *colind = H.colind(), *row = H.row();
+  for (casadi_int v=0; v<H.size2(); ++v) {
+    for (casadi_int w_el=colind[v]; w_el<colind[v+1]; ++w_el) {
+      casadi_int w = row[w_el];
+      if (w==v) continue;
+      if (color[w]==color[v]) return false;
+      for (casadi_int x_el=colind[w]; x_el<colind[w+1]; ++x_el) {
+        casadi_int x = row[x_el];
+        if (x==v || x==w || color[x]!=color[v]) continue;
+        for (casadi_int y_el=colind[x]; y_el<colind[x+1]; ++y_el) {
+          casadi_int y = row[y_el];
+          if (y!=x && y!=w && y!=v && color[y]==color[w]) return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Random pattern with a band and a few random entries per column
+Sparsity random_pattern(casadi_int n, casadi_int band, casadi_int n_random, bool symmetric) {
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<casadi_int> dist(0, n-1);
+  std::vector<casadi_int> r, c;
+  for (casadi_int j=0; j<n; ++j) {
+    for (casadi_int i=std::max(casadi_int(0), j-band); i<=std::min(n-1, j+band); ++i) {
+      r.push_back(i);
+      c.push_back(j);
+    }
+    for (casadi_int k=0; k<n_random; ++k) {
+      casadi_int i = dist(gen);
+      r.push_back(i);
+      c.push_back(j);
+      if (symmetric) {
+        r.push_back(j);
+        c.push_back(i);
+      }
+    }
+  }
+  return Sparsity::triplet(n, n, r, c);
+}
+
+int main(int argc, char* argv[]) {
+  casadi_int n = argc>1 ? atoi(argv[1]) : 1000000;
+  casadi_int max_threads = argc>2 ? atoi(argv[2]) : 8;
+  GlobalOptions::setThreadPoolSize(max_threads);
+
+  Sparsity J = random_pattern(n, 2, 2, false);
+  Sparsity JT = J.T();
+  Sparsity H = random_pattern(n/4, 2, 1, true);
+  std::cout << "Jacobian " << J.dim() << ", Hessian " << H.dim() << std::endl;
+
+  auto t0 = Clock::now();
+  Sparsity D = J.uni_coloring(JT);
+  std::cout << "uni_coloring sequential: " << D.size2() << " colors, "
+            << seconds(t0) << " s, valid " << valid_uni(J, D) << std::endl;
+  for (casadi_int nt=1; nt<=max_threads; nt*=2) {
+    t0 = Clock::now();
+    D = J.uni_coloring_parallel(JT, std::numeric_limits<casadi_int>::max(), nt);
+    std::cout << "uni_coloring parallel, " << nt << " thread(s): " << D.size2() << " colors, "
+              << seconds(t0) << " s, valid " << valid_uni(J, D) << std::endl;
+  }
+
+  t0 = Clock::now();
+  D = H.star_coloring();
+  std::cout << "star_coloring sequential: " << D.size2() << " colors, "
+            << seconds(t0) << " s, valid " << valid_star(H, D) << std::endl;
+  for (casadi_int nt=1; nt<=max_threads; nt*=2) {
+    t0 = Clock::now();
+    D = H.star_coloring_parallel(1, std::numeric_limits<casadi_int>::max(), nt);
+    std::cout << "star_coloring parallel, " << nt << " thread(s): " << D.size2() << " colors, "
+              << seconds(t0) << " s, valid " << valid_star(H, D) << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of integrator output on fine time grids
+
+  Integrates the Van der Pol oscillator with an increasing number of output times.
+  The fixed step integrators are run with and without the 'dense_output' option,
+  CVODES and IDAS for reference: these interpolate the outputs internally already.
+  Reports the number of steps, wall time and the error compared to a tight
+  tolerance CVODES solution.
+*/
+
+#include <casadi/casadi.hpp>
+#include <chrono>
+#include <iostream>
+
+using namespace casadi;
+
+typedef std::chrono::steady_clock Clock;
+
+double seconds(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int main(int argc, char* argv[]) {
+  casadi_int n_max = argc>1 ? atoi(argv[1]) : 10000;
+  casadi_int nk = argc>2 ? atoi(argv[2]) : 200;
+
+  // Van der Pol oscillator with a quadrature
+  SX x = SX::sym("x", 2), p = SX::sym("p");
+  SX ode = vertcat(x(1), p*(1-x(0)*x(0))*x(1) - x(0));
+  SXDict dae = {{"x", x}, {"p", p}, {"ode", ode}, {"quad", x(0)*x(0)}};
+  DMDict arg = {{"x0", DM({1, 0})}, {"p", 0.5}};
+
+  for (casadi_int n = 10; n <= n_max; n *= 10) {
+    std::vector<double> grid;
+    for (casadi_int i = 1; i <= n; ++i) grid.push_back(10. * i / n);
+    std::cout << n << " output times" << std::endl;
+
+    // Reference solution
+    Function ref = integrator("ref", "cvodes", dae, 0, grid,
+      {{"abstol", 1e-12}, {"reltol", 1e-12}});
+    DM xref = ref(arg).at("xf");
+
+    // Fixed step integrators, outputs at step boundaries or interpolated
+    for (std::string plugin : {"rk", "collocation"}) {
+      for (bool dense : {false, true}) {
+        Function F = integrator("F", plugin, dae, 0, grid,
+          {{"number_of_finite_elements", nk}, {"dense_output", dense}});
+        auto t0 = Clock::now();
+        DM xf = F(arg).at("xf");
+        std::cout << "  " << plugin << (dense ? ", dense output: " : ": ")
+                  << F.stats().at("nsteps") << " steps, " << seconds(t0) << " s, error "
+                  << norm_inf(xf - xref) << std::endl;
+      }
+    }
+
+    // Variable step integrators
+    for (std::string plugin : {"cvodes", "idas"}) {
+      Function F = integrator("F", plugin, dae, 0, grid);
+      auto t0 = Clock::now();
+      DM xf = F(arg).at("xf");
+      std::cout << "  " << plugin << ": " << F.stats().at("nsteps") << " steps, "
+                << seconds(t0) << " s, error " << norm_inf(xf - xref) << std::endl;
+    }
+  }
+  return 0;
+}
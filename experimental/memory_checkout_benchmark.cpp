@@ -0,0 +1,90 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Stress benchmark of memory object checkout
+
+  Many threads evaluate the same Function concurrently, each evaluation checking out
+  and releasing a memory object. Prints the evaluation throughput as a function of
+  the number of threads, together with the number of memory objects allocated.
+*/
+
+#include <casadi/casadi.hpp>
+#include <casadi/core/function_internal.hpp>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace casadi;
+
+// Evaluate f n_eval times on each of n_thread threads, return evaluations per second
+double throughput(const Function& f, casadi_int n_thread, casadi_int n_eval,
+                  std::atomic<bool>& failed) {
+  auto worker = [&]() {
+    std::vector<double> x(f.nnz_in(0), 0.3), y(f.nnz_out(0));
+    std::vector<const double*> arg(f.sz_arg(), nullptr);
+    std::vector<double*> res(f.sz_res(), nullptr);
+    std::vector<casadi_int> iw(f.sz_iw());
+    std::vector<double> w(f.sz_w());
+    arg[0] = get_ptr(x);
+    res[0] = get_ptr(y);
+    for (casadi_int r=0; r<n_eval; ++r) {
+      if (f(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w))) failed = true;
+    }
+  };
+  auto t0 = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (casadi_int i=0; i<n_thread; ++i) threads.emplace_back(worker);
+  for (auto& t : threads) t.join();
+  auto t1 = std::chrono::steady_clock::now();
+  return n_thread * n_eval / std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main(int argc, char* argv[]) {
+  casadi_int max_threads = argc>1 ? atoi(argv[1]) : 32;
+  casadi_int n_eval = argc>2 ? atoi(argv[2]) : 200000;
+
+  // Small function: checkout and release dominate the cost of an evaluation
+  SX x = SX::sym("x", 2);
+  Function f("f", {x}, {sin(x(0)) * x(1)});
+  std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+  std::atomic<bool> failed(false);
+  double base = 0;
+  for (casadi_int n_thread=1; n_thread<=max_threads; n_thread*=2) {
+    double r = throughput(f, n_thread, n_eval, failed);
+    if (n_thread==1) base = r;
+    casadi_int n_mem = 0;
+    while (f->has_memory(n_mem)) n_mem++;
+    std::cout << n_thread << " threads: " << r * 1e-6 << " M evaluations/s"
+              << " (scaling " << r / base << ", memory objects " << n_mem << ")" << std::endl;
+  }
+  if (failed) {
+    std::cerr << "Evaluation failed" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of Function serialization formats
+
+  Serializes an NLP solver for a large discretized optimal control problem in the
+  text-safe format (default), in the binary format and in the compressed binary format,
+  then reports size and time needed to save and load, from a string and from a file.
+*/
+
+#include <casadi/casadi.hpp>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+using namespace casadi;
+
+int main(int argc, char* argv[]) {
+  // Number of control intervals
+  casadi_int N = argc>1 ? atoi(argv[1]) : 2000;
+
+  // Hanging chain with nonlinear dynamics, multiple shooting with RK4
+  SX x = SX::sym("x", 2), u = SX::sym("u");
+  SX ode = vertcat(x(1), -sin(x(0)) - 0.1*x(1)*(1 + x(0)*x(0)) + u);
+  Function f("f", {x, u}, {ode});
+  double dt = 10. / N;
+  SX X = SX::sym("X", 2, N+1), U = SX::sym("U", 1, N);
+  std::vector<SX> g;
+  SX J = 0;
+  for (casadi_int k=0; k<N; ++k) {
+    SX xk = X(Slice(), k), uk = U(0, k);
+    SX k1 = f(std::vector<SX>{xk, uk}).at(0);
+    SX k2 = f(std::vector<SX>{xk + dt/2*k1, uk}).at(0);
+    SX k3 = f(std::vector<SX>{xk + dt/2*k2, uk}).at(0);
+    SX k4 = f(std::vector<SX>{xk + dt*k3, uk}).at(0);
+    g.push_back(X(Slice(), k+1) - xk - dt/6*(k1 + 2*k2 + 2*k3 + k4));
+    J += sumsqr(xk) + uk*uk;
+  }
+  SXDict nlp = {{"x", SX::veccat({X, U})}, {"f", J}, {"g", vertcat(g)}};
+  Function solver = nlpsol("solver", "sqpmethod", nlp,
+    Dict{{"qpsol", "qrqp"}, {"print_header", false}, {"print_time", false},
+         {"qpsol_options", Dict{{"print_header", false}}}});
+  Function hess_l = solver.get_function("nlp_hess_l");
+  std::cout << "Hessian of the Lagrangian: " << hess_l.n_instructions()
+            << " instructions" << std::endl;
+
+  std::vector<std::pair<std::string, Dict>> formats = {
+    {"text", Dict()},
+    {"binary", Dict{{"binary", true}}},
+    {"binary+compress", Dict{{"compress", true}}}};
+  for (auto&& fmt : formats) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::string s = solver.serialize(fmt.second);
+    auto t1 = std::chrono::steady_clock::now();
+    Function loaded = Function::deserialize(s);
+    auto t2 = std::chrono::steady_clock::now();
+    casadi_assert(loaded.get_function("nlp_hess_l").n_instructions()==hess_l.n_instructions(),
+      "Round trip failed");
+    std::cout << fmt.first << ": " << s.size() / 1e6 << " MB, save "
+              << std::chrono::duration<double>(t1 - t0).count() * 1e3 << " ms, load "
+              << std::chrono::duration<double>(t2 - t1).count() * 1e3 << " ms" << std::endl;
+
+    // Loading from file reads from a read-only memory mapping
+    std::string fname = "serialization_benchmark.casadi";
+    solver.save(fname, fmt.second);
+    auto t3 = std::chrono::steady_clock::now();
+    loaded = Function::load(fname);
+    auto t4 = std::chrono::steady_clock::now();
+    std::cout << "  Function::load: "
+              << std::chrono::duration<double>(t4 - t3).count() * 1e3 << " ms" << std::endl;
+  }
+  return 0;
+}
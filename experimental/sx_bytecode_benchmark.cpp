@@ -0,0 +1,94 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark of the SXFunction bytecode interpreter
+
+  Compares numerical evaluation of a large SXFunction using the default
+  instruction-by-instruction interpreter with the compact bytecode (option "bytecode")
+  and with machine code generated in memory (option "native_jit").
+*/
+
+#include <casadi/casadi.hpp>
+#include <chrono>
+#include <iostream>
+
+using namespace casadi;
+
+// Evaluate f repeatedly, return average time in seconds
+double time_eval(const Function& f, casadi_int n_rep) {
+  std::vector<double> x(f.nnz_in(0), 0.3), y(f.nnz_out(0));
+  std::vector<const double*> arg(f.sz_arg(), nullptr);
+  std::vector<double*> res(f.sz_res(), nullptr);
+  std::vector<casadi_int> iw(f.sz_iw());
+  std::vector<double> w(f.sz_w());
+  arg[0] = get_ptr(x);
+  res[0] = get_ptr(y);
+  int mem = f.checkout();
+  auto t0 = std::chrono::steady_clock::now();
+  for (casadi_int r=0; r<n_rep; ++r) {
+    f(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), mem);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  f.release(mem);
+  return std::chrono::duration<double>(t1 - t0).count() / n_rep;
+}
+
+int main(int argc, char* argv[]) {
+  // Problem size: number of stages of a nonlinear recursion
+  casadi_int n = argc>1 ? atoi(argv[1]) : 1000;
+  casadi_int n_rep = argc>2 ? atoi(argv[2]) : 20;
+
+  // Large, irregular expression graph
+  SX x = SX::sym("x", 100);
+  SX v = x;
+  for (casadi_int k=0; k<n; ++k) {
+    v = sin(v) * x + cos(vertcat(v(Slice(1, 100)), v(Slice(0, 1)))) / (1 + sq(v)) + 0.1 * k;
+  }
+
+  Function f_switch("f_switch", {x}, {v});
+  Function f_bytecode("f_bytecode", {x}, {v}, Dict{{"bytecode", true}});
+  auto t_jit0 = std::chrono::steady_clock::now();
+  Function f_native("f_native", {x}, {v}, Dict{{"native_jit", true}});
+  auto t_jit1 = std::chrono::steady_clock::now();
+  std::cout << "Number of instructions: " << f_switch.n_instructions() << std::endl;
+
+  // Warm up and check consistency
+  DM x0 = DM::rand(100);
+  double err = norm_inf(f_switch(x0).at(0) - f_bytecode(x0).at(0)).scalar();
+  err = std::max(err, norm_inf(f_switch(x0).at(0) - f_native(x0).at(0)).scalar());
+  std::cout << "Max deviation: " << err << std::endl;
+  std::cout << "Construction with native_jit: "
+            << std::chrono::duration<double>(t_jit1 - t_jit0).count() * 1e3 << " ms" << std::endl;
+
+  double t_switch = time_eval(f_switch, n_rep);
+  double t_bytecode = time_eval(f_bytecode, n_rep);
+  double t_native = time_eval(f_native, n_rep);
+  std::cout << "switch interpreter:   " << t_switch * 1e3 << " ms" << std::endl;
+  std::cout << "bytecode interpreter: " << t_bytecode * 1e3 << " ms"
+            << " (speed-up " << t_switch / t_bytecode << ")" << std::endl;
+  std::cout << "native machine code:  " << t_native * 1e3 << " ms"
+            << " (speed-up " << t_switch / t_native << ")" << std::endl;
+  return 0;
+}
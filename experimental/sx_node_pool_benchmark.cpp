@@ -0,0 +1,105 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of the SX node pool
+
+  Builds a large scalar expression graph, expands an MX Function into SX and destroys
+  the results, with and without GlobalOptions::setSXNodePool. Each phase is also run
+  on several threads concurrently, where allocator contention is most visible.
+*/
+
+#include <casadi/casadi.hpp>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace casadi;
+
+typedef std::chrono::steady_clock Clock;
+
+double seconds(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+struct Timing {
+  double build, expand, destroy;
+};
+
+// Build, expand and destroy a graph of roughly 4*n nodes
+void run(const Function& f_mx, casadi_int n, Timing& t) {
+  auto t0 = Clock::now();
+  SX x = SX::sym("x", 8);
+  SX y = x;
+  for (casadi_int k=0; k<n/8; ++k) {
+    y = sin(y) * x + y / (1 + y * y);
+  }
+  t.build = seconds(t0);
+  t0 = Clock::now();
+  Function f_sx = f_mx.expand();
+  t.expand = seconds(t0);
+  t0 = Clock::now();
+  y = SX();
+  f_sx = Function();
+  t.destroy = seconds(t0);
+}
+
+int main(int argc, char* argv[]) {
+  casadi_int n = argc>1 ? atoi(argv[1]) : 200000;
+  casadi_int n_thread = argc>2 ? atoi(argv[2]) : 4;
+
+  // MX graph of comparable size to expand
+  MX x = MX::sym("x", 8);
+  MX y = x;
+  for (casadi_int k=0; k<n/256; ++k) {
+    y = sin(y) * x + y / (1 + y * y);
+  }
+  Function f_mx("f", {x}, {y});
+  Function f_mx_loop = f_mx.mapaccum("f_loop", 32);
+
+  for (bool pool : {false, true}) {
+    GlobalOptions::setSXNodePool(pool);
+    for (casadi_int nt : {casadi_int(1), n_thread}) {
+      std::vector<Timing> t(nt);
+      auto t0 = Clock::now();
+      std::vector<std::thread> threads;
+      for (casadi_int i=0; i<nt; ++i) {
+        threads.emplace_back([&, i]() { run(f_mx_loop, n, t[i]); });
+      }
+      for (auto& th : threads) th.join();
+      double total = seconds(t0);
+      Timing avg = {0, 0, 0};
+      for (auto& ti : t) {
+        avg.build += ti.build / nt;
+        avg.expand += ti.expand / nt;
+        avg.destroy += ti.destroy / nt;
+      }
+      std::cout << (pool ? "pool" : "new ") << ", " << nt << " thread(s): "
+                << "build " << avg.build << " s, expand " << avg.expand
+                << " s, destroy " << avg.destroy << " s, wall " << total << " s" << std::endl;
+    }
+  }
+  return 0;
+}
@@ -4601,6 +4601,7 @@ namespace casadi {
 %include <casadi/core/importer.hpp>
 %include <casadi/core/callback.hpp>
 %include <casadi/core/global_options.hpp>
+%include <casadi/core/trace_recorder.hpp>
 
 %include <casadi/core/casadi_meta.hpp>
 #ifdef SWIGPYTHON
@@ -30,6 +30,8 @@ from helpers import *
 import pickle
 import os
 import sys
+import tempfile
+import shutil
 from casadi.tools import capture_stdout
 
 scipy_interpolate = False
@@ -584,7 +586,7 @@ class Functiontests(casadiTestCase):
     Z = [MX.sym("z",2,2) for i in range(n)]
     V = [MX.sym("z",Sparsity.upper(3)) for i in range(n)]
 
-    for parallelization in ["serial","openmp","unroll","inline","thread"]:
+    for parallelization in ["serial","openmp","unroll","inline","thread","thread_pool","simd"]:
         print(parallelization)
         res = fun.map(n, parallelization).call([horzcat(*x) for x in [X,Y,Z,V]])
 
@@ -630,6 +632,146 @@ class Functiontests(casadiTestCase):
     self.checkfunction_light(fun.map(4,"thread",2),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
     self.checkfunction_light(fun.map(4,"thread",5),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
 
+  def test_map_simd(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+
+    fun = Function("f",[x,y],[sin(y*x).T+3,if_else(x>0.5,x**2,fmax(x,y[1]))])
+
+    X_ = hcat([ DM(x.sparsity(),np.random.random(x.nnz())) for i in range(11) ])
+    Y_ = hcat([ DM(y.sparsity(),np.random.random(y.nnz())) for i in range(11) ])
+
+    for vector_width in [1,4,8,16]:
+      F = fun.map(11,"simd",{"vector_width":vector_width})
+      self.assertTrue(F.is_a("SimdMap"))
+      self.checkfunction_light(F,fun.map(11),inputs=[X_,Y_])
+      self.checkfunction_light(F.deserialize(F.serialize()),fun.map(11),inputs=[X_,Y_])
+
+    # Fallback for functions that are not SX-based
+    funmx = fun.wrap()
+    F = funmx.map(11,"simd")
+    self.checkfunction_light(F,fun.map(11),inputs=[X_,Y_])
+
+  def test_profile_instructions(self):
+    import json
+    x = SX.sym("x",3)
+    f = Function("f",[x],[sin(x)*x[0]+2],{"profile_instructions":True})
+    X = MX.sym("X",3)
+    A = MX.sym("A",3,3)
+    g = Function("g",[X,A],[mtimes(A,f(X))+solve(A,X)],{"profile_instructions":True})
+    for i in range(5):
+      f([1,2,3])
+      g([1,2,3],2*DM.eye(3))
+    for F in [f,g]:
+      with capture_stdout() as out:
+        F.print_profile()
+      self.assertTrue("Instruction profile of " + F.name() in out[0])
+      F.save_profile("profile.json")
+      with open("profile.json") as fh:
+        trace = json.load(fh)
+      events = trace["traceEvents"]
+      self.assertEqual(len(events),F.n_instructions()+1)
+      # f is also evaluated by g
+      n_call = set(e["args"]["n_call"] for e in events[1:])
+      self.assertEqual(n_call,{10 if F is f else 5})
+    with capture_stdout() as out:
+      g.print_profile()
+    self.assertTrue("solve" in out[0])
+    self.assertTrue("call" in out[0])
+    with self.assertInException("profile_instructions"):
+      Function("h",[x],[x]).print_profile()
+    # The option survives serialization
+    for F, args in [(f,[[1,2,3]]),(g,[[1,2,3],2*DM.eye(3)])]:
+      F = Function.deserialize(F.serialize())
+      F(*args)
+      with capture_stdout() as out:
+        F.print_profile()
+      self.assertTrue("Instruction profile of " + F.name() in out[0])
+
+  def test_trace_recorder(self):
+    import json
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    r = Function("r",[x,p],[vertcat(x[0]**2-p,x[1]-x[0])])
+    rf = rootfinder("rf","newton",r)
+    P = MX.sym("P")
+    g = Function("g",[P],[2*rf(DM.ones(2),P)])
+    self.assertFalse(TraceRecorder.is_enabled())
+    TraceRecorder.enable()
+    g(4)
+    TraceRecorder.disable()
+    g(9)
+    TraceRecorder.save("trace.json")
+    with open("trace.json") as fh:
+      events = json.load(fh)["traceEvents"]
+    names = set(e["name"] for e in events)
+    for n in ["g","rf","r",rf.name()]:
+      self.assertTrue(n in names)
+    self.assertTrue(any(n.endswith(".solve") for n in names))
+    # Begin and end events are properly nested
+    stack = []
+    for e in events:
+      if e["ph"]=="B":
+        stack.append(e["name"])
+      else:
+        self.assertEqual(stack.pop(),e["name"])
+    self.assertEqual(len(stack),0)
+    self.assertEqual(sum(e["name"]=="g" for e in events),2)
+    # Ring buffer overflow keeps a balanced tail
+    TraceRecorder.enable(4)
+    g(4)
+    TraceRecorder.save("trace.json")
+    with open("trace.json") as fh:
+      events = json.load(fh)["traceEvents"]
+    self.assertTrue(len(events)<=4)
+    self.assertEqual(sum(e["ph"]=="B" for e in events),sum(e["ph"]=="E" for e in events))
+    TraceRecorder.disable()
+    TraceRecorder.clear()
+
+  def test_map_thread_pool(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+
+    fun = Function("f",[x,y],[sin(y*x).T,x**2])
+
+    X_ = hcat([ DM(x.sparsity(),np.random.random(x.nnz())) for i in range(10) ])
+    Y_ = hcat([ DM(y.sparsity(),np.random.random(y.nnz())) for i in range(10) ])
+
+    for opts in [{"chunk_size":1},{"chunk_size":3},{"chunk_size":10},
+                 {"num_threads":3,"work_stealing":False},
+                 {"num_threads":4,"chunk_size":2,"work_stealing":True}]:
+      F = fun.map(10,"thread_pool",opts)
+      self.assertTrue(F.is_a("ThreadPoolMap"))
+      # Repeated evaluation reuses the pool and the memory objects
+      for i in range(3):
+        self.checkfunction_light(F,fun.map(10),inputs=[X_,Y_])
+      self.checkfunction_light(F.deserialize(F.serialize()),fun.map(10),inputs=[X_,Y_])
+
+  def test_checkout_stress(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    fun = Function("f",[x,y],[sin(y*x).T,x**2])
+
+    # Released memory objects are reused before new ones are allocated
+    mem = [fun.checkout() for i in range(5)]
+    self.assertEqual(len(set(mem)),5)
+    for m in mem[1:4]: fun.release(m)
+    mem2 = [fun.checkout() for i in range(3)]
+    self.assertEqual(sorted(mem2),sorted(mem[1:4]))
+    self.assertEqual(fun.checkout(),max(mem)+1)
+
+    # Many threads checking out and releasing memory of the same function
+    N = 512
+    X_ = DM.rand(1,N)
+    Y_ = DM.rand(2,N)
+    ref = fun.map(N)(X_,Y_)
+    for n_threads in [2,8,32]:
+      F = fun.map(N,"thread",n_threads)
+      for i in range(10):
+        res = F(X_,Y_)
+        for r,e in zip(res,ref):
+          self.checkarray(r,e)
+
   @memory_heavy()
   def test_mapsum(self):
     x = SX.sym("x")
@@ -1619,6 +1761,26 @@ class Functiontests(casadiTestCase):
       self.checkarray(J,J_ref,digits=5)
       self.assertTrue(J.sparsity()==J_ref.sparsity())
 
+  def test_fd_parallelization(self):
+    x = SX.sym("x",6)
+    e = vertcat(sin(x[0])*x[1],x[2]*x[3]*x[4],exp(x[5])-x[0])
+    x0 = DM.rand(6)
+    X = MX.sym("x",6)
+    for fd_method in ["forward","central","smoothing"]:
+      J_ref = None
+      for fd_options in [{},{"parallelization":"thread"},
+                         {"parallelization":"thread","num_threads":4},
+                         {"parallelization":"openmp","num_threads":2}]:
+        f = Function("f",[x],[e],{"enable_fd":True,"enable_forward":False,"enable_reverse":False,
+                                  "enable_jacobian":False,"fd_method":fd_method,"fd_options":fd_options})
+        J = Function("J",[X],[jacobian(f(X),X)])(x0)
+        if J_ref is None:
+          J_ref = J
+          self.checkarray(J,Function("J_exact",[x],[jacobian(e,x)])(x0),digits=5)
+        else:
+          # Same perturbations, irrespective of the evaluation order
+          self.checkarray(J,J_ref,digits=14)
+
 
   @requires_nlpsol("ipopt")
   def test_common_specific_options(self):
@@ -2001,6 +2163,45 @@ class Functiontests(casadiTestCase):
     self.check_codegen(f,inputs=[np.random.random((3,3))])
     self.check_codegen(f,inputs=[np.random.random((3,3))], opts={"avoid_stack": True})
 
+  def test_codegen_units(self):
+    x = SX.sym("x",3)
+    g = Function('g',[x],[x*2])
+    y = x
+    for k in range(10):
+      y = sin(y)*x[0]+y/(1+y*y)
+    z = y+g(y)
+    for k in range(10):
+      z = cos(z)*x[1]
+    f = Function('f',[x],[z,y])
+    x0 = DM([0.1,0.2,0.3])
+    for opts in [{"chunk_size": 20}, {"chunk_size": 20, "n_units": 3}, {"n_units": 2}]:
+      self.check_codegen(f,inputs=[x0],opts=opts,std="c99")
+      if sys.platform!="win32":
+        fj = Function('f',[x],[z,y],{"jit":True,"compiler":"shell","jit_codegen_options":opts})
+        self.checkfunction_light(fj,f,inputs=[x0])
+    cg = CodeGenerator("f_units",{"n_units":3})
+    cg.add(f)
+    cg.generate()
+    self.assertEqual(cg.units(),["f_units_u1.c","f_units_u2.c"])
+
+  def test_codegen_loop_rolling(self):
+    x = MX.sym("x",3)
+    p = MX.sym("p")
+    y = x
+    for k in range(3):
+      y = sin(y)*p+y/(1+y*y)+2.5
+    f = Function('f',[x,p],[y,dot(y,y)])
+    F = f.map(50).expand()
+    inputs = [DM.rand(3,50),DM.rand(1,50)]
+    for opts in [{"loop_rolling":True},{"loop_rolling":True,"chunk_size":200}]:
+      self.check_codegen(F,inputs=inputs,opts=opts)
+    sizes = []
+    for opts in [{},{"loop_rolling":True}]:
+      cg = CodeGenerator("f_roll",opts)
+      cg.add(F)
+      sizes.append(os.path.getsize(cg.generate()))
+    self.assertTrue(sizes[1]<0.2*sizes[0])
+
 
   def test_serialize(self):
     for opts in [{"debug":True},{}]:
@@ -2746,6 +2947,27 @@ class Functiontests(casadiTestCase):
     f = Function("f",[],[c])
     self.check_codegen(f,inputs=[])
 
+  @requiresPlugin(Importer,"shell")
+  def test_jit_cache(self):
+    if sys.platform=="win32": return
+    cache_dir = tempfile.mkdtemp() + os.sep
+    x = MX.sym("x",2)
+    opts = {"jit":True, "compiler": "shell", "jit_options": {"verbose":True, "cache_dir": cache_dir}}
+    with self.assertOutput(["calling"],["using cached"]):
+      f = Function('f',[x],[sin(x)*x[0]],opts)
+      f(3)
+    self.assertEqual(len([e for e in os.listdir(cache_dir) if e.startswith("casadi_jit_")]),1)
+    with self.assertOutput(["using cached"],["calling"]):
+      g = Function('f',[x],[sin(x)*x[0]],opts)
+      g(3)
+    self.checkfunction_light(f, g, inputs=[DM([0.3,0.7])])
+    # Different flags give a different entry
+    opts["jit_options"]["compiler_flags"] = ["-O1"]
+    with self.assertOutput(["calling"],["using cached"]):
+      Function('f',[x],[sin(x)*x[0]],opts)(3)
+    self.assertEqual(len(os.listdir(cache_dir)),2)
+    shutil.rmtree(cache_dir)
+
   def test_jit_serialize(self):
     if not args.run_slow: return
     if sys.platform=="darwin": return
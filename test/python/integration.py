@@ -1504,6 +1504,113 @@ class Integrationtests(casadiTestCase):
     integrator(x0=1)
     self.assertTrue(integrator.get_function('jacF').is_a("SXFunction"))
     self.checkarray(integrator.get_function('jacF')(x=1)["jac_ode_x"],1) 
+
+  def test_checkpoints(self):
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    u = SX.sym("u")
+    dae = {'x':x, 'p':p, 'u':u, 'ode':vertcat(x[1],-p*sin(x[0])+u-0.1*x[1]), 'quad':x[0]**2}
+    tgrid = [0.3*i for i in range(1,8)]
+    for plugin in ["rk","collocation"]:
+      x0 = MX.sym("x0",2)
+      pp = MX.sym("p")
+      uu = MX.sym("u",1,7)
+      G = []
+      for nc in [-1,1,3,1000]:
+        F = integrator("F", plugin, dae, 0, tgrid, {"number_of_finite_elements":50,"checkpoints":nc})
+        r = F(x0=x0,p=pp,u=uu)
+        obj = sumsqr(r["xf"])+sum2(r["qf"])
+        G.append(Function("G",[x0,pp,uu],[gradient(obj,vertcat(x0,pp,vec(uu)))]))
+        if nc==-1: sz_w_all = F.reverse(1).sz_w()
+        # Only the checkpoints are kept in memory
+        if nc==3: self.assertTrue(F.reverse(1).sz_w()<sz_w_all)
+      for g in G[1:]:
+        self.checkfunction_light(g,G[0],inputs=[vertcat(1,0.2),2,DM(range(7)).T/7])
+
+  def test_dense_output(self):
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    u = SX.sym("u")
+    dae = {'x':x, 'p':p, 'u':u, 'ode':vertcat(x[1],-p*sin(x[0])+u-0.1*x[1]), 'quad':x[0]**2}
+    tgrid = [0.01*i for i in range(1,301)]
+    # Control with step changes at t=1 and t=2
+    u0 = DM([0]*100+[1]*100+[-1]*100).T
+    for plugin in ["rk","collocation"]:
+      x0 = MX.sym("x0",2)
+      pp = MX.sym("p")
+      G = []
+      for dense in [False,True]:
+        F = integrator("F", plugin, dae, 0, tgrid, {"number_of_finite_elements":150,"dense_output":dense})
+        r = F(x0=x0,p=pp,u=u0)
+        # Forward sensitivities of the interpolated outputs
+        seed = vertcat(0.3,0.7,1)
+        G.append(Function("G",[x0,pp],[r["xf"],r["qf"],jtimes(vertcat(r["xf"],r["qf"]),vertcat(x0,pp),seed)]))
+        F(x0=vertcat(1,0.2),p=2,u=u0)
+        if dense:
+          # Steps are no longer placed at every output time
+          self.assertTrue(F.stats()["nsteps"]<nsteps)
+          with self.assertInException("adjoint sensitivities"):
+            F.reverse(1)
+        else:
+          nsteps = F.stats()["nsteps"]
+      self.checkfunction_light(G[1],G[0],inputs=[vertcat(1,0.2),2],digits=7)
+
+  @requires_integrator('cvodes')
+  @requires_integrator('idas')
+  def test_preconditioners(self):
+    n = 20
+    k = 4.
+    x = SX.sym("x",n)
+    p = SX.sym("p")
+    xe = vertcat(0,x,0)
+    dae = {'x':x, 'p':p, 'ode':k*(xe[:-2]-2*x+xe[2:])-p*x**3}
+    # Jacobi preconditioner, from the diagonal of the iteration matrix
+    t = SX.sym("t")
+    xx = SX.sym("x",n)
+    pp = SX.sym("p")
+    g = SX.sym("gamma")
+    tr = SX.sym("tr")
+    r = SX.sym("r",n)
+    jacobi = {"cvodes": Function("jacobi",[t,xx,SX(0,1),pp,SX(0,1),g,tr,r],[r/(1+2*g*k)]),
+              "idas": Function("jacobi",[t,xx,SX(0,1),pp,SX(0,1),g,tr,r],[r/(-2*k-g)])}
+    x0 = MX.sym("x0",n)
+    p0 = MX.sym("p")
+    for plugin in ["cvodes","idas"]:
+      G = []
+      for opts in [{"newton_scheme":"direct"},
+                   {"preconditioner":"block_jacobi","preconditioner_block_size":5},
+                   {"preconditioner":"incomplete_ldl"},
+                   {"preconditioner_function":jacobi[plugin]}]:
+        if "newton_scheme" not in opts: opts["newton_scheme"] = "gmres"
+        opts.update(reltol=1e-10,abstol=1e-10,max_krylov=n)
+        F = integrator("F",plugin,dae,0,1.,opts)
+        xf = F(x0=x0,p=p0)["xf"]
+        G.append(Function("G",[x0,p0],[xf,gradient(sumsqr(xf),vertcat(x0,p0))]))
+      for g in G[1:]:
+        self.checkfunction_light(g,G[0],inputs=[DM.rand(n),1],digits=7)
+      with self.assertInException("iterative Newton scheme"):
+        integrator("F",plugin,dae,0,1.,{"preconditioner":"block_jacobi"})
+      wrong = Function("jacobi",[t,xx,SX(0,1),SX.sym("p",2),SX(0,1),SX.sym("gamma"),tr,r],[r])
+      with self.assertInException("input 3 (p) must have 1 nonzeros"):
+        integrator("F",plugin,dae,0,1.,{"newton_scheme":"gmres","preconditioner_function":wrong})
+
+  def test_batch(self):
+    x = SX.sym("x",2)
+    z = SX.sym("z")
+    p = SX.sym("p")
+    u = SX.sym("u")
+    ode = {'x':x, 'p':p, 'u':u, 'ode':vertcat(x[1],-p*sin(x[0])+u-0.1*x[1]), 'quad':x[0]**2}
+    dae = {'x':x, 'z':z, 'p':p, 'u':u, 'ode':vertcat(x[1],z), 'alg':z+p*sin(x[0])-u+0.1*x[1], 'quad':x[0]**2}
+    tgrid = [0.5,1.0,1.5]
+    N = 5
+    for plugin, d in [("rk",ode),("collocation",ode),("collocation",dae)]:
+      F = integrator("F", plugin, d, 0, tgrid, {"number_of_finite_elements":30})
+      Fb = integrator("F", plugin, d, 0, tgrid, {"number_of_finite_elements":30,"batch":N})
+      self.assertTrue(Fb.is_a("MXFunction"))
+      inputs = [DM.rand(Fb.sparsity_in(i)) for i in range(Fb.n_in())]
+      for i in range(Fb.n_in()):
+        if Fb.name_in(i)=="p": inputs[i] = 1+inputs[i]
+      self.checkfunction_light(Fb,F.map(N),inputs=inputs,digits=10)
        
 if __name__ == '__main__':
     unittest.main()
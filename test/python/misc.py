@@ -434,6 +434,55 @@ class Misctests(casadiTestCase):
     si = FileDeserializer("foo.dat")
     print(si.unpack())
 
+  def test_serialize_binary(self):
+    import os
+    x = SX.sym("x",20)
+    z = x
+    for i in range(20):
+      z = sin(z)*x[0]+cos(z)
+    f = Function("f",[x],[z,jacobian(z,x)])
+    X = MX.sym("X",20)
+    g = Function("g",[X],[mtimes(f(X)[1],f(X)[0])])
+
+    sizes = {}
+    for opts in [{},{"debug":True},{"binary":True},{"binary":True,"debug":True},
+                 {"compress":True},{"compress":True,"debug":True}]:
+      g.save("foo.dat",opts)
+      sizes[str(opts)] = os.path.getsize("foo.dat")
+      self.checkfunction_light(Function.load("foo.dat"),g,inputs=[DM.rand(20)])
+
+      # Several objects in one stream
+      si = FileSerializer("foo.dat",opts)
+      si.pack(g)
+      si.pack(DM.rand(3))
+      si.pack("tail")
+      si = None
+      si = FileDeserializer("foo.dat")
+      self.checkfunction_light(si.unpack(),g,inputs=[DM.rand(20)])
+      self.assertEqual(si.unpack().shape,(3,1))
+      self.assertEqual(si.unpack(),"tail")
+      with self.assertInException("end of stream"):
+        si.unpack()
+
+    # Raw binary data halves the size of the text-safe format
+    self.assertTrue(sizes[str({"binary":True})]<0.6*sizes[str({})])
+    self.assertTrue(sizes[str({"compress":True})]<sizes[str({"binary":True})])
+
+  def test_load_truncated(self):
+    x = SX.sym("x",100)
+    f = Function("f",[x],[cumsum(sin(x))])
+    for opts in [{},{"binary":True},{"compress":True}]:
+      f.save("foo.dat",opts)
+      with open("foo.dat","rb") as fh:
+        data = fh.read()
+      # Files are read through a read-only memory mapping
+      for i in range(3):
+        self.checkfunction_light(Function.load("foo.dat"),f,inputs=[DM.rand(100)])
+      with open("foo.dat","wb") as fh:
+        fh.write(data[:len(data)//2])
+      with self.assertInException("end of stream"):
+        Function.load("foo.dat")
+
   def test_print_time(self):
 
 
@@ -3912,6 +3912,29 @@ class MXtests(casadiTestCase):
     print(f2(*args))
 
     assert f1(*args).sparsity()==f2(*args).sparsity()
+
+  def test_work_allocation(self):
+    x = MX.sym("x",100)
+    y = x
+    for k in range(50):
+      t = sin(y)*y[0]
+      y = t[1:]+1
+    z = mtimes(reshape(x,10,10),reshape(x,10,10))
+    w = solve(z+DM.eye(10)*100,x[:10])
+    fs = {}
+    for alloc in ["greedy","interval"]:
+      fs[alloc] = Function("f",[x],[y,w,y[0]*x],{"work_allocation":alloc})
+      info = fs[alloc].info()
+      self.assertEqual(info["work_allocation"],alloc)
+      self.assertTrue(info["work_allocated"]>=info["work_live_peak"])
+      self.checkfunction_light(fs[alloc],fs["greedy"],inputs=[DM.rand(100)])
+      self.check_codegen(fs[alloc],inputs=[DM.rand(100)])
+      self.check_serialize(fs[alloc],inputs=[DM.rand(100)])
+    # Values of different sizes can share memory
+    self.assertTrue(fs["interval"].info()["work_allocated"]<0.6*fs["greedy"].info()["work_allocated"])
+    self.assertTrue(fs["interval"].sz_w()<fs["greedy"].sz_w())
+    with self.assertInException("work_allocation"):
+      Function("f",[x],[y],{"work_allocation":"foo"})
           
 if __name__ == '__main__':
     unittest.main()
@@ -2381,6 +2381,47 @@ class NLPtests(casadiTestCase):
         solver.stats()
         
         
+  def test_cache_evaluations(self):
+    x=SX.sym("x",2)
+    p=SX.sym("p")
+    nlp={'x':x, 'p':p, 'f':(1-x[0])**2+p*(x[1]-x[0]**2)**2, 'g':x[0]**2+x[1]**2}
+
+    for Solver, solver_options, aux_options in solvers:
+      print("test_cache_evaluations",Solver,solver_options)
+      sol = []
+      for cache in [False,True]:
+        options = dict(solver_options)
+        options["cache_evaluations"] = cache
+        solver = nlpsol("mysolver", Solver, nlp, options)
+        sol.append(solver(x0=[0.5,0.5],p=10,lbg=-inf,ubg=1.5))
+        stats = solver.stats()
+        if cache:
+          self.assertTrue(stats["cache_misses"]>0)
+        else:
+          self.assertFalse("cache_hits" in stats)
+      for k in ["x","f","g","lam_x","lam_g"]:
+        self.checkarray(sol[1][k],sol[0][k],digits=8)
+
+  @requires_nlpsol("sqpmethod")
+  @requires_conic("qrqp")
+  def test_cache_evaluations_soc(self):
+    x=SX.sym("x",2)
+    p=SX.sym("p")
+    nlp={'x':x, 'p':p, 'f':(1-x[0])**2+p*(x[1]-x[0]**2)**2, 'g':x[0]**2+x[1]**2}
+    qpsol_options = {"print_iter":False,"print_header":False,"print_info":False}
+    n_call = []
+    for cache in [False,True]:
+      solver = nlpsol("solver","sqpmethod",nlp,{"qpsol":"qrqp","qpsol_options":qpsol_options,
+        "second_order_corrections":True,"print_iteration":False,"print_header":False,
+        "cache_evaluations":cache})
+      res = solver(x0=[-1.2,1],p=100,lbg=-inf,ubg=1.5)
+      self.checkarray(res["x"],DM([0.907234,0.822755]),digits=5)
+      stats = solver.stats()
+      n_call.append(stats["n_call_nlp_fg"])
+    # The candidate of the second order correction is evaluated again by the line search
+    self.assertTrue(stats["cache_hits"]>0)
+    self.assertEqual(n_call[1],n_call[0]-stats["cache_hits"])
+
   @requires_nlpsol("ipopt")
   @memory_heavy()
   def test_ipopt_custom_hess(self):
@@ -569,5 +569,74 @@ class Sparsitytests(casadiTestCase):
 
 
 
+  def test_coloring_parallel(self):
+    random.seed(1)
+    n = 3000
+    r = [random.randrange(n) for i in range(2*n)]
+    c = [random.randrange(n) for i in range(2*n)]
+    J = Sparsity.triplet(n,n,r+list(range(n)),c+list(range(n)))
+    H = J+J.T()
+
+    def colors(D):
+      ret = [0]*D.size1()
+      for i,j in zip(*D.get_triplet()): ret[i] = j
+      return ret
+
+    for nt in [2,4]:
+      # No two columns sharing a row have the same color
+      D = J.uni_coloring_parallel(J.T(),2**30,nt)
+      color = colors(D)
+      JT = J.T()
+      for k in range(n):
+        cols = JT.row()[JT.colind()[k]:JT.colind()[k+1]]
+        self.assertEqual(len(set(color[j] for j in cols)),len(cols))
+      self.assertTrue(D.size2()<=J.uni_coloring(J.T()).size2()+5)
+
+      # Proper coloring without two-colored paths on four vertices
+      D = H.star_coloring_parallel(1,2**30,nt)
+      color = colors(D)
+      nb = [set(H.row()[H.colind()[k]:H.colind()[k+1]])-set([k]) for k in range(n)]
+      for v in range(n):
+        for w in nb[v]:
+          self.assertNotEqual(color[v],color[w])
+          for x in nb[w]-set([v]):
+            if color[x]!=color[v]: continue
+            for y in nb[x]-set([v,w]):
+              self.assertNotEqual(color[y],color[w])
+
+      # Cutoff
+      self.assertTrue(J.uni_coloring_parallel(J.T(),2,nt).is_null())
+      self.assertTrue(H.star_coloring_parallel(1,2,nt).is_null())
+
+    # Used for Jacobians when enabled globally
+    x = MX.sym("x",n)
+    e = sin(x)+x[[random.randrange(n) for i in range(n)]]**2
+    f = Function("f",[x],[e])
+    GlobalOptions.setColoringThreads(4)
+    try:
+      Jf = Function("f",[x],[e]).jacobian()
+    finally:
+      GlobalOptions.setColoringThreads(1)
+    self.checkfunction_light(Jf,f.jacobian(),inputs=[DM.rand(n),DM(n,1)])
+
+  def test_cache_stats(self):
+    s0 = Sparsity.cache_stats()
+    a = Sparsity.lower(17)
+    b = Sparsity.lower(17)
+    self.assertTrue(a.is_equal(b))
+    self.assertEqual(a.hash(),b.hash())
+    self.assertNotEqual(a.hash(),Sparsity.lower(18).hash())
+    s1 = Sparsity.cache_stats()
+    self.assertTrue(s1["hits"]>s0["hits"])
+    self.assertTrue(s1["misses"]>s0["misses"])
+    self.assertTrue(0<s1["hit_rate"]<1)
+    self.assertTrue(s1["entries"]>=s1["alive"]>=1)
+    self.assertTrue(s1["bytes"]>=17*18//2*8)
+
+    # Patterns with unordered rows are sorted before being cached
+    c = Sparsity(3,1,[0,2],[2,0],True)
+    self.assertEqual(c.row(),[0,2])
+    self.assertEqual(c.hash(),Sparsity(3,1,[0,2],[0,2]).hash())
+
 if __name__ == '__main__':
     unittest.main()
@@ -1947,5 +1947,107 @@ class SXtests(casadiTestCase):
     print(n + Ff(x0,n,x-x0))
     print(taylor(y,x,x0))
 
+  def test_bytecode(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y")
+    g = Function("g",[x],[sin(x)*x[0]])
+    e = vertcat(sin(x)*y+fmax(x,y), if_else(x>0.5,sqrt(x),atan2(y,x)), 3.7, g(x*y), x**y)
+    for opts in [{}, {"live_variables":False}]:
+      f = Function("f",[x,y],[e,y**2,DM.zeros(0,1)],opts)
+      opts["bytecode"] = True
+      fb = Function("f",[x,y],[e,y**2,DM.zeros(0,1)],opts)
+      self.checkfunction_light(fb,f,inputs=[vertcat(0.3,0.7,1.1),0.4])
+      self.checkfunction_light(Function.deserialize(fb.serialize()),f,inputs=[vertcat(0.3,0.7,1.1),0.4])
+
+  def test_native_jit(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y")
+    e = vertcat(sin(x)*y+fmax(x,y), if_else(x>0.5,sqrt(x),atan2(y,x)), 3.7, x**y, -fabs(x)/y,
+                logic_and(x<y,x!=0.7), logic_or(x==y,logic_not(x)), floor(x)+1/x, sq(x)-2*x)
+    for opts in [{}, {"live_variables":False}]:
+      f = Function("f",[x,y],[e,y**2,DM.zeros(0,1)],opts)
+      opts["native_jit"] = True
+      fn = Function("f",[x,y],[e,y**2,DM.zeros(0,1)],opts)
+      for inputs in [[vertcat(0.3,0.7,1.1),0.4], [vertcat(0,-0.7,0.4),0.4]]:
+        self.checkfunction_light(fn,f,inputs=inputs)
+      self.checkfunction_light(Function.deserialize(fn.serialize()),f,inputs=[vertcat(0.3,0.7,1.1),0.4])
+    # Call nodes: falls back to interpreted evaluation
+    g = Function("g",[x],[sin(x)*x[0]])
+    f = Function("f",[x,y],[g(x*y)])
+    fn = Function("f",[x,y],[g(x*y)],{"native_jit":True})
+    self.checkfunction_light(fn,f,inputs=[vertcat(0.3,0.7,1.1),0.4])
+
+  def test_just_in_time_sparsity(self):
+    n = 300
+    x = SX.sym("x",n)
+    p = SX.sym("p",2)
+    v = x
+    for k in range(2):
+      v = sin(v)*vertcat(v[7:],v[:7])+p[k]*v
+    e = [vertcat(v,sum1(x[:100]),3), x[:5]]
+    for w in [0,1]:
+      f = Function("f",[x,p],e,{"ad_weight_sp":w})
+      for nd in [64,128,256,512]:
+        for nt in [0,1,3]:
+          g = Function("g",[x,p],e,{"ad_weight_sp":w,"just_in_time_sparsity":True,
+                                    "sparsity_directions":nd,"sparsity_threads":nt})
+          for i in range(2):
+            for j in range(2):
+              self.assertTrue(g.jac_sparsity(i,j)==f.jac_sparsity(i,j))
+    g = Function.deserialize(g.serialize())
+    self.assertTrue(g.jac_sparsity(0,0)==f.jac_sparsity(0,0))
+    with self.assertInException("sparsity_directions"):
+      Function("g",[x,p],e,{"just_in_time_sparsity":True,"sparsity_directions":100})
+
+  def test_node_pool(self):
+    backup = GlobalOptions.getSXNodePool()
+    x = SX.sym("x",4)
+    def build():
+      v = x
+      for k in range(50):
+        v = sin(v)*x+v/(1+v*v)
+      return v
+    GlobalOptions.setSXNodePool(False)
+    v_ref = build()
+    f_ref = Function("f",[x],[v_ref])
+    try:
+      GlobalOptions.setSXNodePool(True)
+      v = build()
+      # Mix pooled and unpooled nodes in one graph
+      GlobalOptions.setSXNodePool(False)
+      f = Function("f",[x],[v,cos(v)])
+      GlobalOptions.setSXNodePool(True)
+      fe = Function("fe",[x],[v_ref]).expand()
+      del v
+      self.checkfunction_light(Function("f",[x],[f(x)[0]]),f_ref,inputs=[DM([0.1,0.2,0.3,0.4])])
+      self.checkfunction_light(fe,f_ref,inputs=[DM([0.1,0.2,0.3,0.4])])
+    finally:
+      GlobalOptions.setSXNodePool(backup)
+
+  def test_hash_consing(self):
+    backup = GlobalOptions.getSXHashConsing()
+    x = SX.sym("x",2)
+    def build():
+      r = 0
+      for i in range(10):
+        t = x
+        for k in range(5):
+          t = sin(t)*x[0]+x[1]*t
+        r = r + t
+      return r
+    GlobalOptions.setSXHashConsing(False)
+    r_ref = build()
+    f_ref = Function("f",[x],[r_ref,jacobian(r_ref,x)])
+    try:
+      GlobalOptions.setSXHashConsing(True)
+      self.assertTrue(is_equal(x[0]+x[1],x[1]+x[0],0))
+      self.assertFalse(is_equal(x[0]-x[1],x[1]-x[0],0))
+      r = build()
+      self.assertTrue(n_nodes(r)<n_nodes(r_ref)/5)
+      f = Function("f",[x],[r,jacobian(r,x)])
+      self.checkfunction_light(f,f_ref,inputs=[DM([0.3,0.2])])
+    finally:
+      GlobalOptions.setSXHashConsing(backup)
+
 if __name__ == '__main__':
     unittest.main()